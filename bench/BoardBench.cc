@@ -0,0 +1,174 @@
+
+#include "Board.hh"
+#include <benchmark/benchmark.h>
+#include <cstdio>
+
+namespace pge {
+namespace {
+
+/// @brief - The seed used to generate the boards, so that all the runs
+/// measure the same boards.
+constexpr auto BENCH_SEED = 42u;
+
+constexpr auto MIN_BOARD_DIMS = 32;
+constexpr auto MAX_BOARD_DIMS = 4096;
+
+/// @brief - The number of moves played before measuring the queries.
+constexpr auto OPENING_MOVES = 16;
+
+/// @brief - Generates a square board and plays some moves on it so that
+/// the territories are not trivial.
+/// @param dims - the width and height of the board.
+/// @param moves - the number of moves to play.
+auto generateBoard(int dims, int moves) -> BoardShPtr
+{
+  auto board = std::make_shared<Board>(dims, dims, BENCH_SEED);
+
+  auto owner = Owner::Player;
+  for (auto id = 0; id < moves && board->status() == Status::Running; ++id)
+  {
+    board->changeColorOf(owner, board->bestColorFor(owner));
+    owner = opponentOf(owner);
+  }
+
+  return board;
+}
+
+void boardSizes(benchmark::internal::Benchmark *bench)
+{
+  bench->RangeMultiplier(2)->Range(MIN_BOARD_DIMS, MAX_BOARD_DIMS)->Unit(benchmark::kMicrosecond);
+}
+
+void BM_Construction(benchmark::State &state)
+{
+  const auto dims = static_cast<int>(state.range(0));
+
+  for (auto _ : state)
+  {
+    Board board(dims, dims, BENCH_SEED);
+    benchmark::DoNotOptimize(board);
+  }
+
+  state.SetItemsProcessed(state.iterations() * dims * dims);
+}
+
+void BM_ChangeColorOf(benchmark::State &state)
+{
+  const auto dims = static_cast<int>(state.range(0));
+  auto board      = generateBoard(dims, 0);
+
+  auto owner = Owner::Player;
+  auto color = 0;
+  for (auto _ : state)
+  {
+    // Colors are picked in turn rather than with `bestColorFor`, so that
+    // only the move itself is measured.
+    do
+    {
+      color = (color + 1) % static_cast<int>(Color::Count);
+    } while (!board->regions().canPick(owner, static_cast<Color>(color)));
+
+    board->changeColorOf(owner, static_cast<Color>(color));
+    owner = opponentOf(owner);
+
+    if (board->status() != Status::Running)
+    {
+      state.PauseTiming();
+      board = generateBoard(dims, 0);
+      owner = Owner::Player;
+      state.ResumeTiming();
+    }
+  }
+}
+
+void BM_BestColorFor(benchmark::State &state)
+{
+  const auto dims  = static_cast<int>(state.range(0));
+  const auto board = generateBoard(dims, OPENING_MOVES);
+
+  for (auto _ : state)
+  {
+    benchmark::DoNotOptimize(board->bestColorFor(Owner::Player));
+  }
+}
+
+void BM_IsPlayerAndAiInContact(benchmark::State &state)
+{
+  const auto dims  = static_cast<int>(state.range(0));
+  const auto board = generateBoard(dims, OPENING_MOVES);
+
+  for (auto _ : state)
+  {
+    benchmark::DoNotOptimize(board->isPlayerAndAiInContact());
+  }
+}
+
+void BM_UpdateStatus(benchmark::State &state)
+{
+  // The status is cached by the board and computed after each move from
+  // the regions: this measures the computation itself.
+  const auto dims  = static_cast<int>(state.range(0));
+  const auto board = generateBoard(dims, OPENING_MOVES);
+
+  std::array<int, static_cast<int>(Owner::Count)> finals{};
+  for (auto _ : state)
+  {
+    benchmark::DoNotOptimize(board->regions().decided(finals));
+  }
+}
+
+void BM_OccupiedBy(benchmark::State &state)
+{
+  const auto dims  = static_cast<int>(state.range(0));
+  const auto board = generateBoard(dims, OPENING_MOVES);
+
+  for (auto _ : state)
+  {
+    benchmark::DoNotOptimize(board->occupiedBy(Owner::Player));
+    benchmark::DoNotOptimize(board->occupiedBy(Owner::AI));
+  }
+}
+
+void BM_Save(benchmark::State &state)
+{
+  const auto dims  = static_cast<int>(state.range(0));
+  const auto board = generateBoard(dims, OPENING_MOVES);
+  const auto file  = std::string("bench_save_") + std::to_string(dims) + ".ext";
+
+  for (auto _ : state)
+  {
+    board->save(file);
+  }
+
+  std::remove(file.c_str());
+  state.SetItemsProcessed(state.iterations() * dims * dims);
+}
+
+void BM_Load(benchmark::State &state)
+{
+  const auto dims = static_cast<int>(state.range(0));
+  const auto file = std::string("bench_load_") + std::to_string(dims) + ".ext";
+  generateBoard(dims, OPENING_MOVES)->save(file);
+
+  Board board(MIN_BOARD_DIMS, MIN_BOARD_DIMS);
+  for (auto _ : state)
+  {
+    board.load(file);
+  }
+
+  std::remove(file.c_str());
+  state.SetItemsProcessed(state.iterations() * dims * dims);
+}
+
+} // namespace
+
+BENCHMARK(BM_Construction)->Apply(boardSizes);
+BENCHMARK(BM_ChangeColorOf)->Apply(boardSizes);
+BENCHMARK(BM_BestColorFor)->Apply(boardSizes);
+BENCHMARK(BM_IsPlayerAndAiInContact)->Apply(boardSizes);
+BENCHMARK(BM_UpdateStatus)->Apply(boardSizes);
+BENCHMARK(BM_OccupiedBy)->Apply(boardSizes);
+BENCHMARK(BM_Save)->Apply(boardSizes);
+BENCHMARK(BM_Load)->Apply(boardSizes);
+
+} // namespace pge
@@ -0,0 +1,26 @@
+
+#include <core_utils/log/Locator.hh>
+#include <core_utils/log/PrefixedLogger.hh>
+#include <core_utils/log/StdLogger.hh>
+
+#include <benchmark/benchmark.h>
+
+int main(int argc, char **argv)
+{
+  // Logs are kept to a minimum so that they don't weigh on the timings.
+  utils::log::StdLogger raw;
+  raw.setLevel(utils::log::Severity::INFO);
+  utils::log::PrefixedLogger logger("pge", "bench");
+  utils::log::Locator::provide(&raw);
+
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv))
+  {
+    return 1;
+  }
+
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+
+  return 0;
+}
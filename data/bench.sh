@@ -0,0 +1,6 @@
+#!/bin/sh
+
+export LD_LIBRARY_PATH=/usr/local/lib/:$LD_LIBRARY_PATH
+
+CURR_DIR=$(dirname $0)
+./bin/square-color-bench --benchmark_out=bench.json --benchmark_out_format=json
@@ -73,6 +73,22 @@ void App::onInputs(const controls::State &c, const CoordinateFrame &cf)
       m_state->save();
     }
   }
+
+  if (c.keys[controls::keys::U])
+  {
+    if (m_state->getScreen() == Screen::Game)
+    {
+      m_game->undo();
+    }
+  }
+
+  if (c.keys[controls::keys::A])
+  {
+    if (m_state->getScreen() == Screen::Game)
+    {
+      m_game->cycleAI();
+    }
+  }
 }
 
 void App::loadData()
@@ -222,7 +238,7 @@ inline void App::drawWarpedSprite(const SpriteDesc &t, const CoordinateFrame &cf
 
 inline void App::drawRect(const SpriteDesc &t, const CoordinateFrame &cf)
 {
-  olc::vf2d p = cf.tilesToPixels(t.x, t.y + 1.0f);
+  olc::vf2d p = cf.tilesToPixels(t.x, t.y + t.radius);
   FillRectDecal(p, t.radius * cf.tileSize(), t.sprite.tint);
 }
 
@@ -233,6 +249,22 @@ void App::renderBoard(const CoordinateFrame &cf)
   const float hw = b.width() / 2.0f;
   const float hh = b.height() / 2.0f;
 
+  // Uniform blocks of the board are drawn at once when they are known.
+  if (const auto *tree = b.quadTree(); tree != nullptr)
+  {
+    tree->visit([&](const int x, const int y, const int size, const QuadTree::Value value) {
+      SpriteDesc sp;
+      sp.x           = 1.0f * x - hw;
+      sp.y           = 1.0f * y - hh;
+      sp.radius      = 1.0f * size;
+      sp.sprite.tint = olcColorFromCellColor(b.cellOf(value).color);
+
+      drawRect(sp, cf);
+    });
+
+    return;
+  }
+
   for (int y = 0; y < b.height(); ++y)
   {
     for (int x = 0; x < b.width(); ++x)
@@ -78,7 +78,8 @@ class App : public PGEApp
   void drawWarpedSprite(const SpriteDesc &t, const CoordinateFrame &cf);
 
   /// @brief - Used to draw a simple rect at the specified location. Note that we
-  /// reuse the sprite desc but don't actually use the sprite.
+  /// reuse the sprite desc but don't actually use the sprite. The rect covers
+  /// `radius` tiles along each axis starting from the position of the desc.
   /// @param t - the description of the tile to draw.
   /// @param cf - the coordinate frame to use to perform the conversion from tile
   /// position to pixels.
@@ -0,0 +1,391 @@
+
+#include "AlphaBetaEngine.hh"
+#include <algorithm>
+#include <atomic>
+#include <core_utils/TimeUtils.hh>
+#include <vector>
+
+namespace pge::ai {
+namespace {
+
+/// @brief - A bound larger than any score, which can be negated safely.
+constexpr auto INFINITE_SCORE = 1 << 30;
+
+/// @brief - Distinguishes the positions where the AI is to play from the
+/// ones where the player is to play in the transposition table.
+constexpr auto AI_TO_PLAY_KEY = std::uint64_t{0x2545f4914f6cdd1du};
+
+/// @brief - The depth stored in the transposition table for positions whose
+/// search reached the end of the game on all its lines: their score does
+/// not depend on the depth anymore.
+constexpr auto SOLVED_DEPTH = 0xFFFF;
+
+/// @brief - The number of positions visited between two checks of the
+/// deadline of a search, when the positions are cheap to visit.
+constexpr auto NODES_PER_CHECK = 1024;
+
+/// @brief - The conditions stopping a search, shared by all its threads.
+struct Limits
+{
+  // Raised when the engine is aborted.
+  const std::atomic<bool> &aborted;
+
+  // Whether the search has a deadline.
+  bool timed;
+  utils::TimeStamp deadline;
+
+  // Raised by the first thread noticing that the deadline is over.
+  std::atomic<bool> expired;
+};
+
+/// @brief - The data used by a single thread during a search.
+struct Context
+{
+  // The table shared by all the threads.
+  TranspositionTable &table;
+
+  Limits &limits;
+
+  // The number of positions visited.
+  int nodes;
+
+  // The number of searches of the outcome run on the graph of the thread
+  // when the deadline was last checked.
+  int searches;
+
+  // Whether the search stopped at the depth limit on at least one line of
+  // the current subtree, rather than at the end of the game.
+  bool horizon;
+
+  // Buffer receiving the regions absorbed or released by a move, which are
+  // not needed by the search.
+  std::vector<int> absorbed;
+
+  // Buffer receiving the final number of cells of the owners in decided
+  // positions.
+  std::array<int, static_cast<int>(Owner::Count)> finals;
+};
+
+/// @brief - Whether the search should stop right away. The deadline is
+/// checked every few positions, and after each search of the outcome of a
+/// position: these visit all the regions of the board, so that a few of
+/// them take longer than many positions on large boards.
+bool stopped(const RegionGraph &graph, Context &context) noexcept
+{
+  auto &limits = context.limits;
+  if (limits.aborted || limits.expired)
+  {
+    return true;
+  }
+  if (!limits.timed)
+  {
+    return false;
+  }
+
+  const auto searches = graph.searches();
+  if (context.nodes % NODES_PER_CHECK != 0 && searches == context.searches)
+  {
+    return false;
+  }
+
+  context.searches = searches;
+  if (utils::now() > limits.deadline)
+  {
+    limits.expired = true;
+    return true;
+  }
+
+  return false;
+}
+
+/// @brief - The outcome of the search of a move at the root.
+struct RootResult
+{
+  int score;
+
+  // Whether the score is exact: a move which does not beat the bound it
+  // was searched with only gets an upper bound of its score.
+  bool exact;
+
+  int nodes;
+
+  bool horizon;
+};
+
+int negamax(RegionGraph &graph, const Owner &owner, int depth, int alpha, int beta, Context &context)
+{
+  ++context.nodes;
+
+  if (stopped(graph, context))
+  {
+    return 0;
+  }
+  if (graph.contested() == 0)
+  {
+    return evaluate(graph, owner);
+  }
+  // The score of a decided position is exact whatever the depth left.
+  if (graph.decided(context.finals))
+  {
+    return finalScore(context.finals, owner);
+  }
+  if (depth == 0)
+  {
+    context.horizon = true;
+    return evaluate(graph, owner);
+  }
+
+  const auto hash  = graph.hash() ^ (owner == Owner::AI ? AI_TO_PLAY_KEY : 0u);
+  const auto lower = alpha;
+
+  TableEntry entry;
+  auto hint = Color::Count;
+  if (context.table.probe(hash, entry))
+  {
+    hint = entry.move;
+
+    if (entry.depth >= depth)
+    {
+      const auto horizon = entry.depth != SOLVED_DEPTH;
+
+      switch (entry.bound)
+      {
+        case Bound::Exact:
+          context.horizon = context.horizon || horizon;
+          return entry.score;
+        case Bound::Lower:
+          alpha = std::max(alpha, entry.score);
+          break;
+        case Bound::Upper:
+        default:
+          beta = std::min(beta, entry.score);
+          break;
+      }
+
+      if (alpha >= beta)
+      {
+        context.horizon = context.horizon || horizon;
+        return entry.score;
+      }
+    }
+  }
+
+  Moves moves;
+  const auto count = generateMoves(graph, owner, moves);
+
+  // The best move found by a previous search is tried first.
+  for (auto id = 1; id < count; ++id)
+  {
+    if (moves[id].color == hint)
+    {
+      std::rotate(moves.begin(), moves.begin() + id, moves.begin() + id + 1);
+      break;
+    }
+  }
+
+  // Track whether this subtree reaches the depth limit on its own.
+  const auto horizon = context.horizon;
+  context.horizon    = false;
+
+  auto best     = -INFINITE_SCORE;
+  auto bestMove = moves[0].color;
+  for (auto id = 0; id < count && alpha < beta; ++id)
+  {
+    context.absorbed.clear();
+    graph.absorb(owner, moves[id].color, context.absorbed);
+    const auto score = -negamax(graph, opponentOf(owner), depth - 1, -beta, -alpha, context);
+    graph.undo(context.absorbed);
+
+    // The scores of a stopped search are not reliable: they should not
+    // reach the table.
+    if (stopped(graph, context))
+    {
+      return 0;
+    }
+
+    if (score > best)
+    {
+      best     = score;
+      bestMove = moves[id].color;
+    }
+
+    alpha = std::max(alpha, score);
+  }
+
+  auto bound = Bound::Exact;
+  if (best <= lower)
+  {
+    bound = Bound::Upper;
+  }
+  else if (best >= beta)
+  {
+    bound = Bound::Lower;
+  }
+
+  const auto stored = context.horizon ? depth : SOLVED_DEPTH;
+  context.table.store(hash, TableEntry{best, stored, bound, bestMove});
+  context.horizon = context.horizon || horizon;
+
+  return best;
+}
+
+/// @brief - Searches a move at the root with the best bound found so far,
+/// and raises the bound if the move beats it.
+auto searchRoot(const RegionGraph &graph,
+                const Owner &owner,
+                const Color &color,
+                int depth,
+                TranspositionTable &table,
+                Limits &limits,
+                std::atomic<int> &alpha) -> RootResult
+{
+  auto child = graph;
+
+  Context context{table, limits, 0, child.searches(), false, {}, {}};
+  child.absorb(owner, color, context.absorbed);
+
+  const auto bound = alpha.load();
+  const auto score = -negamax(child, opponentOf(owner), depth - 1, -INFINITE_SCORE, -bound, context);
+
+  auto current = bound;
+  while (score > current && !alpha.compare_exchange_weak(current, score))
+  {
+  }
+
+  return RootResult{score, score > bound, context.nodes, context.horizon};
+}
+
+/// @brief - Searches all the moves at the root at a given depth.
+auto searchDepth(const RegionGraph &graph,
+                 const Owner &owner,
+                 const Moves &moves,
+                 int count,
+                 int depth,
+                 TranspositionTable &table,
+                 ThreadPool *pool,
+                 Limits &limits,
+                 bool &horizon) -> SearchResult
+{
+  // The first move is usually the best one: searching it alone provides a
+  // tight bound for the other moves.
+  std::atomic<int> alpha(-INFINITE_SCORE);
+  const auto first = searchRoot(graph, owner, moves[0].color, depth, table, limits, alpha);
+
+  SearchResult out{moves[0].color, first.score, first.nodes, depth};
+  horizon = first.horizon;
+
+  std::vector<RootResult> results(count);
+  if (pool == nullptr)
+  {
+    for (auto id = 1; id < count; ++id)
+    {
+      results[id] = searchRoot(graph, owner, moves[id].color, depth, table, limits, alpha);
+    }
+  }
+  else
+  {
+    std::vector<std::future<RootResult>> futures;
+    for (auto id = 1; id < count; ++id)
+    {
+      const auto color = moves[id].color;
+      futures.push_back(pool->submit([&graph, &owner, color, depth, &table, &limits, &alpha]() {
+        return searchRoot(graph, owner, color, depth, table, limits, alpha);
+      }));
+    }
+
+    for (auto id = 1; id < count; ++id)
+    {
+      results[id] = futures[id - 1].get();
+    }
+  }
+
+  for (auto id = 1; id < count; ++id)
+  {
+    out.nodes += results[id].nodes;
+    horizon = horizon || results[id].horizon;
+
+    if (results[id].exact && results[id].score > out.score)
+    {
+      out.color = moves[id].color;
+      out.score = results[id].score;
+    }
+  }
+
+  return out;
+}
+
+} // namespace
+
+AlphaBetaEngine::AlphaBetaEngine(int depth, ThreadPoolShPtr pool, int budgetMs)
+  : Engine("alpha-beta")
+  , m_depth(depth)
+  , m_budget(budgetMs)
+  , m_pool(std::move(pool))
+  , m_table(std::make_shared<TranspositionTable>(DEFAULT_TABLE_BITS))
+{
+  if (m_depth <= 0)
+  {
+    error("Failed to create alpha-beta engine", "Invalid depth " + std::to_string(m_depth));
+  }
+  if (m_budget < 0)
+  {
+    error("Failed to create alpha-beta engine", "Invalid budget " + std::to_string(m_budget) + "ms");
+  }
+}
+
+auto AlphaBetaEngine::search(const RegionGraph &graph, const Owner &owner) -> SearchResult
+{
+  Limits limits{aborted(), m_budget > 0, utils::now() + utils::toMilliseconds(m_budget), {false}};
+  m_table->attach(graph.fingerprint());
+
+  Moves moves;
+  const auto count = generateMoves(graph, owner, moves);
+
+  // Once the outcome is decided, the moves only change how fast the
+  // game ends: there is nothing left to search.
+  std::array<int, static_cast<int>(Owner::Count)> finals{};
+  if (graph.decided(finals))
+  {
+    return SearchResult{moves[0].color, finalScore(finals, owner), 1, 0};
+  }
+
+  // Used when not even the first iteration completes in time.
+  SearchResult out{moves[0].color, evaluate(graph, owner), 1, 0};
+
+  for (auto depth = 1; depth <= m_depth; ++depth)
+  {
+    // The best move of the previous iteration is searched first.
+    for (auto id = 1; id < count; ++id)
+    {
+      if (moves[id].color == out.color)
+      {
+        std::rotate(moves.begin(), moves.begin() + id, moves.begin() + id + 1);
+        break;
+      }
+    }
+
+    auto horizon = false;
+    const auto res
+      = searchDepth(graph, owner, moves, count, depth, *m_table, m_pool.get(), limits, horizon);
+
+    out.nodes += res.nodes;
+    if (limits.aborted || limits.expired)
+    {
+      break;
+    }
+
+    out.color = res.color;
+    out.score = res.score;
+    out.depth = depth;
+
+    // Deeper searches would not see anything new.
+    if (!horizon)
+    {
+      break;
+    }
+  }
+
+  return out;
+}
+
+} // namespace pge::ai
@@ -0,0 +1,68 @@
+
+#pragma once
+
+#include "Engine.hh"
+#include "Search.hh"
+#include "ThreadPool.hh"
+#include "TranspositionTable.hh"
+
+namespace pge::ai {
+
+/// @brief - The default number of moves explored ahead by the search engines,
+/// counting the moves of both owners.
+constexpr auto DEFAULT_SEARCH_DEPTH = 6;
+
+/// @brief - The depth explored by engines limited by time rather than by
+/// depth: they can't go deeper than this in the time they are given.
+constexpr auto MAX_SEARCH_DEPTH = 64;
+
+/// @brief - The number of bits of the hash of the positions used to index
+/// the transposition table of the engines.
+constexpr auto DEFAULT_TABLE_BITS = 20;
+
+/// @brief - An engine exploring the moves of both owners a fixed number of
+/// moves ahead with a negamax search, pruned with alpha-beta. Moves are
+/// explored by decreasing gain, so that the best ones usually come first
+/// and produce more cutoffs.
+/// The search runs on copies of the graph of regions of the board, which
+/// only duplicate the state of the game: each thread applies and undoes
+/// the moves in place on its own copy.
+/// When a thread pool is provided the moves at the root are split between
+/// its threads: the first move is searched alone to get a bound, and the
+/// other ones are searched in parallel, sharing the best bound found so far.
+/// The results of the searches of the positions are kept in a transposition
+/// table shared by all the threads and from one move to the next, as long
+/// as the moves are played on the same board.
+/// The search is iteratively deepened: the depth grows by one move at a
+/// time until the maximum depth or the time budget is reached, and the best
+/// move of the deepest completed iteration is kept. The moves found by an
+/// iteration are explored first by the next one, which keeps the overhead
+/// of the shallow iterations low.
+class AlphaBetaEngine : public Engine
+{
+  public:
+  /// @brief - Create a new engine searching at the specified depth.
+  /// @param depth - the maximum number of moves explored ahead, counting the
+  /// moves of both owners.
+  /// @param pool - the threads to search on. When empty the search runs on
+  /// the calling thread.
+  /// @param budgetMs - the time allowed for each move, in milliseconds. When
+  /// `0` the search always reaches the maximum depth.
+  AlphaBetaEngine(int depth, ThreadPoolShPtr pool = nullptr, int budgetMs = 0);
+
+  /// @brief - Searches the best color to play for an owner.
+  /// @param graph - the state of the game.
+  /// @param owner - the owner to play.
+  /// @return - the result of the deepest iteration which completed.
+  auto search(const RegionGraph &graph, const Owner &owner) -> SearchResult override;
+
+  private:
+  int m_depth;
+  int m_budget;
+
+  ThreadPoolShPtr m_pool;
+
+  TranspositionTableShPtr m_table;
+};
+
+} // namespace pge::ai
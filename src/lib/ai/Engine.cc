@@ -0,0 +1,89 @@
+
+#include "Engine.hh"
+#include "AlphaBetaEngine.hh"
+#include "GreedyEngine.hh"
+#include "ExhaustiveEngine.hh"
+#include "MctsEngine.hh"
+
+namespace pge::ai {
+
+Engine::Engine(const std::string &name)
+  : utils::CoreObject(name)
+{
+  setService("ai");
+}
+
+auto Engine::pick(const Board &board, const Owner &owner) -> Color
+{
+  const auto res = search(board.regions(), owner);
+
+  debug("Picked " + colorName(res.color) + " with score " + std::to_string(res.score) + " at depth "
+        + std::to_string(res.depth) + " after " + std::to_string(res.nodes) + " node(s)");
+
+  return res.color;
+}
+
+void Engine::abort() noexcept
+{
+  m_aborted = true;
+}
+
+void Engine::resume() noexcept
+{
+  m_aborted = false;
+}
+
+bool Engine::delegated() const noexcept
+{
+  return m_delegated;
+}
+
+auto Engine::aborted() const noexcept -> const std::atomic<bool> &
+{
+  return m_aborted;
+}
+
+void Engine::setDelegated(bool delegated) noexcept
+{
+  m_delegated = delegated;
+}
+
+auto newEngine(const Kind &kind) -> EngineShPtr
+{
+  switch (kind)
+  {
+    case Kind::AlphaBeta:
+      return std::make_shared<AlphaBetaEngine>(MAX_SEARCH_DEPTH,
+                                               sharedThreadPool(),
+                                               DEFAULT_TIME_BUDGET_MS);
+    case Kind::Mcts:
+      return std::make_shared<MctsEngine>(DEFAULT_TIME_BUDGET_MS, sharedThreadPool());
+    case Kind::Exhaustive:
+      return std::make_shared<ExhaustiveEngine>(sharedThreadPool(),
+                                                DEFAULT_EXHAUSTIVE_TABLE_BITS,
+                                                newEngine(Kind::AlphaBeta),
+                                                DEFAULT_TIME_BUDGET_MS);
+    case Kind::Greedy:
+    default:
+      return std::make_shared<GreedyEngine>();
+  }
+}
+
+auto kindName(const Kind &kind) -> std::string
+{
+  switch (kind)
+  {
+    case Kind::Greedy:
+      return "greedy";
+    case Kind::AlphaBeta:
+      return "alpha-beta";
+    case Kind::Mcts:
+      return "mcts";
+    case Kind::Exhaustive:
+      return "exhaustive";
+    default:
+      return "unknown";
+  }
+}
+
+} // namespace pge::ai
@@ -0,0 +1,85 @@
+
+#pragma once
+
+#include "Board.hh"
+#include "Search.hh"
+#include <atomic>
+#include <core_utils/CoreObject.hh>
+#include <memory>
+
+namespace pge::ai {
+
+/// @brief - The default time an engine is allowed to think before picking
+/// a color.
+constexpr auto DEFAULT_TIME_BUDGET_MS = 500;
+
+/// @brief - The kinds of AI available to play against.
+enum class Kind
+{
+  Greedy,
+  AlphaBeta,
+  Mcts,
+  Exhaustive,
+  Count
+};
+
+/// @brief - Common interface for the AI engines: an engine picks the color
+/// an owner should play on a board.
+class Engine : public utils::CoreObject
+{
+  public:
+  /// @brief - Create a new engine with the specified name.
+  /// @param name - the name of the engine, used in logs.
+  Engine(const std::string &name);
+
+  virtual ~Engine() = default;
+
+  /// @brief - Picks the color to play for an owner.
+  /// @param board - the board on which the owner plays.
+  /// @param owner - the owner for which a color should be picked.
+  /// @return - the color to play.
+  auto pick(const Board &board, const Owner &owner) -> Color;
+
+  /// @brief - Searches the best color to play for an owner. Engines are not
+  /// meant to run several searches at once.
+  /// @param graph - the state of the game.
+  /// @param owner - the owner to play.
+  /// @return - the result of the search.
+  virtual auto search(const RegionGraph &graph, const Owner &owner) -> SearchResult = 0;
+
+  /// @brief - Requests the search in progress to stop as soon as possible,
+  /// in which case its result is meaningless. The searches keep stopping
+  /// right away until `resume` is called.
+  virtual void abort() noexcept;
+
+  /// @brief - Allows searches to run again after a call to `abort`.
+  virtual void resume() noexcept;
+
+  /// @brief - Whether the last search was left to another engine, for the
+  /// engines which only handle the positions they can afford to search.
+  /// @return - `true` if the last move was not picked by this engine.
+  bool delegated() const noexcept;
+
+  protected:
+  /// @brief - The flag raised by `abort`, to be polled by the searches.
+  auto aborted() const noexcept -> const std::atomic<bool> &;
+
+  /// @brief - Records whether the current search is left to another engine.
+  void setDelegated(bool delegated) noexcept;
+
+  private:
+  std::atomic<bool> m_aborted{false};
+  std::atomic<bool> m_delegated{false};
+};
+
+using EngineShPtr = std::shared_ptr<Engine>;
+
+/// @brief - Creates an engine of the specified kind with its default
+/// settings.
+/// @param kind - the kind of engine to create.
+/// @return - the created engine.
+auto newEngine(const Kind &kind) -> EngineShPtr;
+
+auto kindName(const Kind &kind) -> std::string;
+
+} // namespace pge::ai
@@ -0,0 +1,355 @@
+
+#include "ExhaustiveEngine.hh"
+#include <algorithm>
+#include <atomic>
+#include <core_utils/TimeUtils.hh>
+#include <vector>
+
+namespace pge::ai {
+namespace {
+
+/// @brief - A bound larger than any score, which can be negated safely.
+constexpr auto INFINITE_SCORE = 1 << 30;
+
+/// @brief - Distinguishes the positions where the AI is to play from the
+/// ones where the player is to play in the table.
+constexpr auto AI_TO_PLAY_KEY = std::uint64_t{0x2545f4914f6cdd1du};
+
+/// @brief - The depth stored in the table for all the positions: they are
+/// searched until the end of the game.
+constexpr auto END_OF_GAME_DEPTH = 0xFFFF;
+
+/// @brief - The number of positions visited between two checks of the
+/// deadline of a search, when the positions are cheap to visit.
+constexpr auto NODES_PER_CHECK = 1024;
+
+/// @brief - The conditions stopping a search, shared by all its threads.
+struct Limits
+{
+  // Raised when the engine is aborted.
+  const std::atomic<bool> &aborted;
+
+  // Whether the search has a deadline.
+  bool timed;
+  utils::TimeStamp deadline;
+
+  // Raised by the first thread noticing that the deadline is over.
+  std::atomic<bool> expired;
+};
+
+/// @brief - The data used by a single thread during a search.
+struct Context
+{
+  TranspositionTable &table;
+
+  Limits &limits;
+
+  // The number of positions visited.
+  int nodes;
+
+  // The number of searches of the outcome run on the graph of the thread
+  // when the deadline was last checked.
+  int searches;
+
+  // Buffers receiving the regions absorbed or released by a move, and the
+  // final number of cells of the owners in decided positions.
+  std::vector<int> absorbed;
+  std::array<int, static_cast<int>(Owner::Count)> finals;
+};
+
+/// @brief - Whether the search should stop right away. As for the
+/// alpha-beta engine, the deadline is checked every few positions and after
+/// each search of the outcome of a position.
+bool stopped(const RegionGraph &graph, Context &context) noexcept
+{
+  auto &limits = context.limits;
+  if (limits.aborted || limits.expired)
+  {
+    return true;
+  }
+  if (!limits.timed)
+  {
+    return false;
+  }
+
+  const auto searches = graph.searches();
+  if (context.nodes % NODES_PER_CHECK != 0 && searches == context.searches)
+  {
+    return false;
+  }
+
+  context.searches = searches;
+  if (utils::now() > limits.deadline)
+  {
+    limits.expired = true;
+    return true;
+  }
+
+  return false;
+}
+
+int negamax(RegionGraph &graph, const Owner &owner, int alpha, int beta, Context &context)
+{
+  ++context.nodes;
+
+  if (stopped(graph, context))
+  {
+    return 0;
+  }
+  if (graph.contested() == 0)
+  {
+    return evaluate(graph, owner);
+  }
+  if (graph.decided(context.finals))
+  {
+    return finalScore(context.finals, owner);
+  }
+
+  const auto hash  = graph.hash() ^ (owner == Owner::AI ? AI_TO_PLAY_KEY : 0u);
+  const auto lower = alpha;
+
+  TableEntry entry;
+  auto hint = Color::Count;
+  if (context.table.probe(hash, entry))
+  {
+    hint = entry.move;
+
+    switch (entry.bound)
+    {
+      case Bound::Exact:
+        return entry.score;
+      case Bound::Lower:
+        alpha = std::max(alpha, entry.score);
+        break;
+      case Bound::Upper:
+      default:
+        beta = std::min(beta, entry.score);
+        break;
+    }
+
+    if (alpha >= beta)
+    {
+      return entry.score;
+    }
+  }
+
+  Moves moves;
+  const auto count = generateMoves(graph, owner, moves);
+
+  for (auto id = 1; id < count; ++id)
+  {
+    if (moves[id].color == hint)
+    {
+      std::rotate(moves.begin(), moves.begin() + id, moves.begin() + id + 1);
+      break;
+    }
+  }
+
+  auto best     = -INFINITE_SCORE;
+  auto bestMove = moves[0].color;
+  for (auto id = 0; id < count && alpha < beta; ++id)
+  {
+    context.absorbed.clear();
+    graph.absorb(owner, moves[id].color, context.absorbed);
+    const auto score = -negamax(graph, opponentOf(owner), -beta, -alpha, context);
+    graph.undo(context.absorbed);
+
+    // The scores of a stopped search should not reach the table.
+    if (stopped(graph, context))
+    {
+      return 0;
+    }
+
+    if (score > best)
+    {
+      best     = score;
+      bestMove = moves[id].color;
+    }
+
+    alpha = std::max(alpha, score);
+  }
+
+  auto bound = Bound::Exact;
+  if (best <= lower)
+  {
+    bound = Bound::Upper;
+  }
+  else if (best >= beta)
+  {
+    bound = Bound::Lower;
+  }
+
+  context.table.store(hash, TableEntry{best, END_OF_GAME_DEPTH, bound, bestMove});
+
+  return best;
+}
+
+/// @brief - The outcome of the search of a move at the root.
+struct RootResult
+{
+  int score;
+
+  // Whether the score is exact rather than an upper bound.
+  bool exact;
+
+  int nodes;
+};
+
+/// @brief - Searches a move at the root with the best bound found so far,
+/// and raises the bound if the move beats it.
+auto searchRoot(const RegionGraph &graph,
+                const Owner &owner,
+                const Color &color,
+                TranspositionTable &table,
+                Limits &limits,
+                std::atomic<int> &alpha) -> RootResult
+{
+  auto child = graph;
+
+  Context context{table, limits, 0, child.searches(), {}, {}};
+  child.absorb(owner, color, context.absorbed);
+
+  const auto bound = alpha.load();
+  const auto score = -negamax(child, opponentOf(owner), -INFINITE_SCORE, -bound, context);
+
+  auto current = bound;
+  while (score > current && !alpha.compare_exchange_weak(current, score))
+  {
+  }
+
+  return RootResult{score, score > bound, context.nodes};
+}
+
+} // namespace
+
+ExhaustiveEngine::ExhaustiveEngine(ThreadPoolShPtr pool,
+                                   int tableBits,
+                                   EngineShPtr fallback,
+                                   int budgetMs)
+  : Engine("exhaustive")
+  , m_budget(budgetMs)
+  , m_pool(std::move(pool))
+  , m_table(nullptr)
+  , m_fallback(std::move(fallback))
+{
+  if (tableBits <= 0 || tableBits > 32)
+  {
+    error("Failed to create exhaustive engine",
+          "Invalid table size " + std::to_string(tableBits) + " bit(s)");
+  }
+  if (m_budget < 0)
+  {
+    error("Failed to create exhaustive engine",
+          "Invalid budget " + std::to_string(m_budget) + "ms");
+  }
+
+  m_table = std::make_shared<TranspositionTable>(tableBits);
+}
+
+auto ExhaustiveEngine::search(const RegionGraph &graph, const Owner &owner) -> SearchResult
+{
+  const auto cells = graph.count(Owner::Player) + graph.count(Owner::AI)
+                     + graph.count(Owner::Nobody);
+  if (m_fallback != nullptr && cells > MAX_EXHAUSTIVE_CELLS)
+  {
+    return delegate(graph, owner, "Board has " + std::to_string(cells) + " cell(s)");
+  }
+
+  setDelegated(false);
+
+  Limits limits{aborted(), m_budget > 0, utils::now() + utils::toMilliseconds(m_budget), {false}};
+  m_table->attach(graph.fingerprint());
+
+  Moves moves;
+  const auto count = generateMoves(graph, owner, moves);
+
+  std::array<int, static_cast<int>(Owner::Count)> finals{};
+  if (graph.decided(finals))
+  {
+    return SearchResult{moves[0].color, finalScore(finals, owner), 1, 0};
+  }
+
+  // The first move provides a bound for the other ones.
+  std::atomic<int> alpha(-INFINITE_SCORE);
+  const auto first = searchRoot(graph, owner, moves[0].color, *m_table, limits, alpha);
+
+  SearchResult out{moves[0].color, first.score, first.nodes, 0};
+
+  std::vector<RootResult> results(count);
+  if (m_pool == nullptr)
+  {
+    for (auto id = 1; id < count; ++id)
+    {
+      results[id] = searchRoot(graph, owner, moves[id].color, *m_table, limits, alpha);
+    }
+  }
+  else
+  {
+    std::vector<std::future<RootResult>> futures;
+    for (auto id = 1; id < count; ++id)
+    {
+      const auto color = moves[id].color;
+      futures.push_back(m_pool->submit([this, &graph, &owner, color, &limits, &alpha]() {
+        return searchRoot(graph, owner, color, *m_table, limits, alpha);
+      }));
+    }
+
+    for (auto id = 1; id < count; ++id)
+    {
+      results[id] = futures[id - 1].get();
+    }
+  }
+
+  for (auto id = 1; id < count; ++id)
+  {
+    out.nodes += results[id].nodes;
+
+    if (results[id].exact && results[id].score > out.score)
+    {
+      out.color = moves[id].color;
+      out.score = results[id].score;
+    }
+  }
+
+  if (limits.expired && !limits.aborted)
+  {
+    if (m_fallback != nullptr)
+    {
+      return delegate(graph, owner, "Search ran out of time");
+    }
+
+    return SearchResult{moves[0].color, evaluate(graph, owner), out.nodes, 0};
+  }
+
+  return out;
+}
+
+void ExhaustiveEngine::abort() noexcept
+{
+  Engine::abort();
+  if (m_fallback != nullptr)
+  {
+    m_fallback->abort();
+  }
+}
+
+void ExhaustiveEngine::resume() noexcept
+{
+  Engine::resume();
+  if (m_fallback != nullptr)
+  {
+    m_fallback->resume();
+  }
+}
+
+auto ExhaustiveEngine::delegate(const RegionGraph &graph,
+                                const Owner &owner,
+                                const std::string &reason) -> SearchResult
+{
+  setDelegated(true);
+  debug("Leaving move to fallback engine", reason);
+
+  return m_fallback->search(graph, owner);
+}
+
+} // namespace pge::ai
@@ -0,0 +1,91 @@
+
+#pragma once
+
+#include "Engine.hh"
+#include "Search.hh"
+#include "ThreadPool.hh"
+#include "TranspositionTable.hh"
+
+namespace pge::ai {
+
+/// @brief - The largest number of cells of a board which can be searched
+/// until the end of the game in a reasonable time, which is about the size
+/// of a 8x8 board.
+constexpr auto MAX_EXHAUSTIVE_CELLS = 64;
+
+/// @brief - The number of bits of the hash of the positions used to index
+/// the table of the positions searched until the end of the game. Each slot
+/// takes 16 bytes.
+constexpr auto DEFAULT_EXHAUSTIVE_TABLE_BITS = 22;
+
+/// @brief - An engine exploring the moves of both owners until the end of
+/// the game with a negamax search, pruned with alpha-beta, and returning the
+/// final difference of cells between the owners.
+/// Moves are the ones of `generateMoves`: an owner only picks a color
+/// bringing no cell when no color brings any, which guarantees that the
+/// game ends. The result is exact for this game only: in the real game an
+/// owner may also pick a color bringing nothing to keep it away from the
+/// other owner, and such moves are never searched.
+/// Positions are identified by the hash of their state and the owner to
+/// play, so the ones reached through different sequences of moves are only
+/// searched once. Their results are kept in a table of fixed size, which
+/// bounds the memory used by the engine. The table only holds the positions
+/// of one board: it is emptied when the engine is used on another board.
+/// A position is scored as soon as its outcome is decided, without playing
+/// the remaining moves.
+/// When a thread pool is provided the moves at the root are split between
+/// its threads, as for the alpha-beta engine.
+/// Boards larger than `MAX_EXHAUSTIVE_CELLS` and searches running out of
+/// time are left to the fallback engine, which is reported by `delegated`.
+/// The positions fully searched before the time ran out are kept in the
+/// table for the next moves.
+class ExhaustiveEngine : public Engine
+{
+  public:
+  /// @brief - Create a new exhaustive engine.
+  /// @param pool - the threads to search on. When empty the search runs on
+  /// the calling thread.
+  /// @param tableBits - the number of bits used to index the table of the
+  /// searched positions.
+  /// @param fallback - the engine used for boards which are too large and
+  /// for searches running out of time. When empty, all boards are searched
+  /// and the greedy move is played when the time runs out.
+  /// @param budgetMs - the time allowed for each move, in milliseconds. When
+  /// `0` the search always reaches the end of the game. A move left to the
+  /// fallback engine after the time ran out also uses the budget of the
+  /// fallback engine.
+  ExhaustiveEngine(ThreadPoolShPtr pool = nullptr,
+                   int tableBits        = DEFAULT_EXHAUSTIVE_TABLE_BITS,
+                   EngineShPtr fallback = nullptr,
+                   int budgetMs         = 0);
+
+  /// @brief - Searches the position for an owner until the end of the game.
+  /// @param graph - the state of the game.
+  /// @param owner - the owner to play.
+  /// @return - the best move, with the difference between the final number
+  /// of cells of the owner and the one of its opponent as score, or the
+  /// result of the fallback engine.
+  auto search(const RegionGraph &graph, const Owner &owner) -> SearchResult override;
+
+  /// @brief - Aborts the search in progress, including the one of the
+  /// fallback engine.
+  void abort() noexcept override;
+
+  /// @brief - Allows searches to run again, including the ones of the
+  /// fallback engine.
+  void resume() noexcept override;
+
+  private:
+  int m_budget;
+
+  ThreadPoolShPtr m_pool;
+
+  TranspositionTableShPtr m_table;
+
+  EngineShPtr m_fallback;
+
+  auto delegate(const RegionGraph &graph, const Owner &owner, const std::string &reason)
+    -> SearchResult;
+};
+
+} // namespace pge::ai
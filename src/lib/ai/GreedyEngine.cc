@@ -0,0 +1,16 @@
+
+#include "GreedyEngine.hh"
+
+namespace pge::ai {
+
+GreedyEngine::GreedyEngine()
+  : Engine("greedy")
+{}
+
+auto GreedyEngine::search(const RegionGraph &graph, const Owner &owner) -> SearchResult
+{
+  const auto color = graph.bestColor(owner);
+  return SearchResult{color, graph.gain(owner, color), 1, 1};
+}
+
+} // namespace pge::ai
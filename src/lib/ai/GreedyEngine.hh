@@ -0,0 +1,18 @@
+
+#pragma once
+
+#include "Engine.hh"
+
+namespace pge::ai {
+
+/// @brief - An engine picking the color bringing the most cells right away,
+/// as `RegionGraph::bestColor` does.
+class GreedyEngine : public Engine
+{
+  public:
+  GreedyEngine();
+
+  auto search(const RegionGraph &graph, const Owner &owner) -> SearchResult override;
+};
+
+} // namespace pge::ai
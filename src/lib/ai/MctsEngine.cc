@@ -0,0 +1,304 @@
+
+#include "MctsEngine.hh"
+#include <cmath>
+#include <core_utils/TimeUtils.hh>
+#include <random>
+
+namespace pge::ai {
+namespace {
+
+/// @brief - The weight of the exploration term of the UCT formula.
+constexpr auto EXPLORATION = 1.4f;
+
+/// @brief - The number of iterations between two checks of the time budget.
+constexpr auto ITERATIONS_PER_CHECK = 64;
+
+/// @brief - The probability for a playout to pick the move bringing the
+/// most cells rather than a random one.
+constexpr auto GREEDY_PLAYOUT_RATIO = 0.5f;
+
+} // namespace
+
+class MctsEngine::Searcher
+{
+  public:
+  /// @brief - A node of the tree of moves.
+  struct Node
+  {
+    // The color played to reach this node.
+    Color color;
+
+    // The owner who played this color.
+    Owner owner;
+
+    int parent;
+
+    // The children of the node are stored in a contiguous range starting
+    // at `first`. A node which was not expanded yet has no children.
+    int first;
+    int count;
+
+    int visits;
+
+    // The sum of the rewards of the playouts which went through this node,
+    // from the point of view of the owner who played its color.
+    float wins;
+  };
+
+  Searcher()
+    : m_rng(std::random_device()())
+  {}
+
+  /// @brief - Grows a new tree from the input position until the deadline.
+  /// @param graph - the position to search.
+  /// @param owner - the owner to play.
+  /// @param end - the deadline of the search.
+  /// @param aborted - a flag stopping the search when raised.
+  /// @return - the number of playouts.
+  int run(const RegionGraph &graph,
+          const Owner &owner,
+          const utils::TimeStamp &end,
+          const std::atomic<bool> &aborted)
+  {
+    m_state = graph;
+    m_tree.clear();
+    m_tree.push_back(Node{Color::Count, opponentOf(owner), -1, 0, 0, 0, 0.0f});
+    expand(0, owner);
+
+    const auto depth = m_state.history();
+    auto playouts    = 0;
+
+    // With a single move there is nothing to search.
+    while (m_tree[0].count > 1 && !aborted
+           && (playouts % ITERATIONS_PER_CHECK != 0 || utils::now() < end))
+    {
+      auto id   = 0;
+      auto next = owner;
+      while (m_tree[id].count > 0)
+      {
+        id = select(m_tree[id]);
+        m_absorbed.clear();
+        m_state.absorb(next, m_tree[id].color, m_absorbed);
+        next = opponentOf(next);
+      }
+
+      if (m_tree[id].visits > 0 && m_state.contested() > 0)
+      {
+        expand(id, next);
+        id = m_tree[id].first;
+        m_absorbed.clear();
+        m_state.absorb(next, m_tree[id].color, m_absorbed);
+        next = opponentOf(next);
+      }
+
+      backpropagate(id, playout(next));
+      ++playouts;
+
+      // Go back to the root position.
+      while (m_state.history() > depth)
+      {
+        m_absorbed.clear();
+        m_state.undo(m_absorbed);
+      }
+    }
+
+    return playouts;
+  }
+
+  /// @brief - The moves available at the root of the tree, in the order of
+  /// the move generator.
+  auto root() const noexcept -> const Node &
+  {
+    return m_tree[0];
+  }
+
+  auto node(int id) const noexcept -> const Node &
+  {
+    return m_tree[id];
+  }
+
+  private:
+  std::minstd_rand m_rng;
+
+  /// @brief - The nodes of the tree of the current search. The root is the
+  /// first node.
+  std::vector<Node> m_tree{};
+
+  /// @brief - The position of the current iteration.
+  RegionGraph m_state{};
+
+  /// @brief - Buffer receiving the regions absorbed or released by a move,
+  /// which are not needed by the search.
+  std::vector<int> m_absorbed{};
+
+  auto select(const Node &node) const noexcept -> int
+  {
+    const auto logVisits = std::log(static_cast<float>(node.visits));
+
+    auto best      = node.first;
+    auto bestScore = -1.0f;
+    for (auto id = node.first; id < node.first + node.count; ++id)
+    {
+      const auto &child = m_tree[id];
+      if (child.visits == 0)
+      {
+        return id;
+      }
+
+      const auto score = child.wins / child.visits
+                         + EXPLORATION * std::sqrt(logVisits / child.visits);
+      if (score > bestScore)
+      {
+        best      = id;
+        bestScore = score;
+      }
+    }
+
+    return best;
+  }
+
+  void expand(int id, const Owner &owner)
+  {
+    Moves moves;
+    const auto count = generateMoves(m_state, owner, moves);
+
+    const auto first = static_cast<int>(m_tree.size());
+    for (auto m = 0; m < count; ++m)
+    {
+      m_tree.push_back(Node{moves[m].color, owner, id, 0, 0, 0, 0.0f});
+    }
+
+    m_tree[id].first = first;
+    m_tree[id].count = count;
+  }
+
+  auto playout(Owner owner) -> Owner
+  {
+    std::uniform_real_distribution<float> ratio(0.0f, 1.0f);
+    Moves moves;
+
+    while (m_state.contested() > 0)
+    {
+      const auto count = generateMoves(m_state, owner, moves);
+
+      auto m = 0;
+      if (ratio(m_rng) >= GREEDY_PLAYOUT_RATIO)
+      {
+        m = std::uniform_int_distribution<int>(0, count - 1)(m_rng);
+      }
+
+      m_absorbed.clear();
+      m_state.absorb(owner, moves[m].color, m_absorbed);
+      owner = opponentOf(owner);
+    }
+
+    const auto score = evaluate(m_state, Owner::Player);
+    if (score > 0)
+    {
+      return Owner::Player;
+    }
+    if (score < 0)
+    {
+      return Owner::AI;
+    }
+
+    return Owner::Nobody;
+  }
+
+  void backpropagate(int id, const Owner &winner) noexcept
+  {
+    while (id >= 0)
+    {
+      auto &node = m_tree[id];
+
+      ++node.visits;
+      if (winner == Owner::Nobody)
+      {
+        node.wins += 0.5f;
+      }
+      else if (winner == node.owner)
+      {
+        node.wins += 1.0f;
+      }
+
+      id = node.parent;
+    }
+  }
+};
+
+MctsEngine::MctsEngine(int budgetMs, ThreadPoolShPtr pool)
+  : Engine("mcts")
+  , m_budget(budgetMs)
+  , m_pool(std::move(pool))
+{
+  if (m_budget <= 0)
+  {
+    error("Failed to create mcts engine", "Invalid budget " + std::to_string(m_budget) + "ms");
+  }
+
+  const auto count = m_pool == nullptr ? 1 : m_pool->size();
+  for (auto id = 0; id < count; ++id)
+  {
+    m_searchers.push_back(std::make_unique<Searcher>());
+  }
+}
+
+MctsEngine::~MctsEngine() = default;
+
+auto MctsEngine::search(const RegionGraph &graph, const Owner &owner) -> SearchResult
+{
+  const auto end = utils::now() + utils::toMilliseconds(m_budget);
+  auto playouts  = 0;
+
+  if (m_pool == nullptr)
+  {
+    playouts = m_searchers[0]->run(graph, owner, end, aborted());
+  }
+  else
+  {
+    std::vector<std::future<int>> futures;
+    for (auto &searcher : m_searchers)
+    {
+      futures.push_back(m_pool->submit([this, s = searcher.get(), &graph, &owner, &end]() {
+        return s->run(graph, owner, end, aborted());
+      }));
+    }
+
+    for (auto &future : futures)
+    {
+      playouts += future.get();
+    }
+  }
+
+  // All the trees share the same moves at the root: their statistics can
+  // be summed move by move.
+  const auto &root = m_searchers[0]->root();
+
+  SearchResult out{Color::Count, 0, playouts, 0};
+  auto bestVisits = -1;
+
+  for (auto m = 0; m < root.count; ++m)
+  {
+    auto visits = 0;
+    auto wins   = 0.0f;
+    for (const auto &searcher : m_searchers)
+    {
+      const auto &node = searcher->node(searcher->root().first + m);
+      visits += node.visits;
+      wins += node.wins;
+    }
+
+    if (visits > bestVisits)
+    {
+      const auto rate = visits > 0 ? wins / visits : 0.0f;
+
+      out.color  = m_searchers[0]->node(root.first + m).color;
+      out.score  = static_cast<int>(100.0f * rate);
+      bestVisits = visits;
+    }
+  }
+
+  return out;
+}
+
+} // namespace pge::ai
@@ -0,0 +1,55 @@
+
+#pragma once
+
+#include "Engine.hh"
+#include "Search.hh"
+#include "ThreadPool.hh"
+#include <memory>
+#include <vector>
+
+namespace pge::ai {
+
+/// @brief - An engine running a Monte Carlo Tree Search: the tree of moves
+/// is grown one node per iteration, selecting the nodes to explore with the
+/// UCT formula and scoring them by playing the game until its end with a
+/// mix of random and greedy moves.
+/// The search stops when its time budget is elapsed, so the strength of the
+/// engine scales with the time it is given.
+/// The playouts run on a single copy of the graph of regions: the moves of
+/// each iteration are undone to go back to the root position, which reuses
+/// its buffers and keeps the iterations free of allocations.
+/// When a thread pool is provided, each of its threads grows its own tree
+/// and the statistics of the moves at the root are summed at the end.
+class MctsEngine : public Engine
+{
+  public:
+  /// @brief - Create a new engine with the specified time budget.
+  /// @param budgetMs - the time allowed for each move, in milliseconds.
+  /// @param pool - the threads to search on. When empty the search runs on
+  /// the calling thread.
+  MctsEngine(int budgetMs, ThreadPoolShPtr pool = nullptr);
+
+  ~MctsEngine() override;
+
+  /// @brief - Searches the best color to play for an owner.
+  /// @param graph - the state of the game.
+  /// @param owner - the owner to play.
+  /// @return - the result of the search. The score is the percentage of
+  /// playouts won through the picked color and the nodes are the number
+  /// of playouts.
+  auto search(const RegionGraph &graph, const Owner &owner) -> SearchResult override;
+
+  private:
+  /// @brief - Grows a tree of moves on a single thread.
+  class Searcher;
+
+  int m_budget;
+
+  ThreadPoolShPtr m_pool;
+
+  /// @brief - One searcher per thread of the pool, kept from one search to
+  /// the next to reuse their buffers.
+  std::vector<std::unique_ptr<Searcher>> m_searchers{};
+};
+
+} // namespace pge::ai
@@ -0,0 +1,114 @@
+
+#include "Ponderer.hh"
+#include <algorithm>
+
+namespace pge::ai {
+
+Ponderer::Ponderer(EngineShPtr engine)
+  : utils::CoreObject("ponderer")
+  , m_engine(std::move(engine))
+{
+  setService("ai");
+}
+
+Ponderer::~Ponderer()
+{
+  stop();
+}
+
+void Ponderer::start(const RegionGraph &graph, const Owner &owner)
+{
+  stop();
+
+  {
+    const std::lock_guard<std::mutex> guard(m_lock);
+    m_replies.clear();
+  }
+
+  m_stop = false;
+  m_task = std::async(std::launch::async, [this, graph, owner]() mutable {
+    ponder(std::move(graph), owner);
+  });
+}
+
+void Ponderer::stop()
+{
+  if (!m_task.valid())
+  {
+    return;
+  }
+
+  // The search in progress is aborted: its reply is dropped.
+  m_stop = true;
+  m_engine->abort();
+  m_task.get();
+  m_engine->resume();
+}
+
+bool Ponderer::reply(std::uint64_t hash, Color &color) const
+{
+  const std::lock_guard<std::mutex> guard(m_lock);
+
+  const auto it = m_replies.find(hash);
+  if (it == m_replies.end())
+  {
+    return false;
+  }
+
+  color = it->second;
+  return true;
+}
+
+void Ponderer::ponder(RegionGraph graph, const Owner &owner)
+{
+  const auto opponent = opponentOf(owner);
+  if (graph.contested() == 0)
+  {
+    return;
+  }
+
+  // Every color the opponent can pick is explored, not only the ones which
+  // bring cells: they are ordered by decreasing gain as the opponent is
+  // more likely to pick the colors which bring more cells.
+  Moves moves;
+  auto count = 0;
+  for (auto cId = 0; cId < static_cast<int>(Color::Count); ++cId)
+  {
+    const auto color = static_cast<Color>(cId);
+    if (graph.canPick(opponent, color))
+    {
+      moves[count] = Move{color, graph.gain(opponent, color)};
+      ++count;
+    }
+  }
+
+  std::stable_sort(moves.begin(), moves.begin() + count, [](const Move &lhs, const Move &rhs) {
+    return lhs.gain > rhs.gain;
+  });
+
+  std::vector<int> absorbed;
+  auto found = 0;
+  for (auto id = 0; id < count && !m_stop; ++id)
+  {
+    graph.absorb(opponent, moves[id].color, absorbed);
+
+    const auto hash = graph.hash();
+    const auto res  = m_engine->search(graph, owner);
+
+    graph.undo(absorbed);
+    absorbed.clear();
+
+    if (m_stop)
+    {
+      break;
+    }
+
+    const std::lock_guard<std::mutex> guard(m_lock);
+    m_replies[hash] = res.color;
+    ++found;
+  }
+
+  debug("Pondered " + std::to_string(found) + " repl(ies) out of " + std::to_string(count));
+}
+
+} // namespace pge::ai
@@ -0,0 +1,60 @@
+
+#pragma once
+
+#include "Engine.hh"
+#include <atomic>
+#include <future>
+#include <mutex>
+#include <unordered_map>
+
+namespace pge::ai {
+
+/// @brief - Uses the time where an owner waits for its opponent to search
+/// its replies in advance: each move the opponent can play is applied in
+/// turn, from the most to the least likely, and the reply of the engine is
+/// cached with the hash of the resulting position. When the opponent plays
+/// a move which was already explored, the reply is available right away.
+class Ponderer : public utils::CoreObject
+{
+  public:
+  /// @brief - Create a new ponderer searching with the input engine. The
+  /// engine should not be used elsewhere while pondering.
+  /// @param engine - the engine to search the replies with.
+  Ponderer(EngineShPtr engine);
+
+  /// @brief - Stops pondering.
+  ~Ponderer() override;
+
+  /// @brief - Starts searching the replies of an owner to the moves of its
+  /// opponent in the background. The replies of the previous position are
+  /// forgotten.
+  /// @param graph - the position where the opponent is to play.
+  /// @param owner - the owner whose replies are searched.
+  void start(const RegionGraph &graph, const Owner &owner);
+
+  /// @brief - Stops pondering: the search in progress is aborted and its
+  /// reply dropped. The replies found so far are kept.
+  void stop();
+
+  /// @brief - Looks for the reply found for a position.
+  /// @param hash - the hash of the position.
+  /// @param color - output color, only set when a reply is found.
+  /// @return - `true` if a reply is found.
+  bool reply(std::uint64_t hash, Color &color) const;
+
+  private:
+  EngineShPtr m_engine;
+
+  std::atomic<bool> m_stop{false};
+  std::future<void> m_task{};
+
+  /// @brief - Protects the replies, which are written by the background task.
+  mutable std::mutex m_lock{};
+  std::unordered_map<std::uint64_t, Color> m_replies{};
+
+  void ponder(RegionGraph graph, const Owner &owner);
+};
+
+using PondererShPtr = std::shared_ptr<Ponderer>;
+
+} // namespace pge::ai
@@ -0,0 +1,56 @@
+
+#include "Search.hh"
+
+namespace pge::ai {
+
+int generateMoves(const RegionGraph &graph, const Owner &owner, Moves &moves) noexcept
+{
+  auto count = 0;
+
+  for (auto cId = 0; cId < static_cast<int>(Color::Count); ++cId)
+  {
+    const auto color = static_cast<Color>(cId);
+    if (!graph.canPick(owner, color))
+    {
+      continue;
+    }
+
+    const auto gain = graph.gain(owner, color);
+    if (gain == 0)
+    {
+      continue;
+    }
+
+    // Insertion in the sorted list: there are at most a handful of moves.
+    auto id = count;
+    while (id > 0 && moves[id - 1].gain < gain)
+    {
+      moves[id] = moves[id - 1];
+      --id;
+    }
+
+    moves[id] = Move{color, gain};
+    ++count;
+  }
+
+  if (count == 0)
+  {
+    moves[0] = Move{graph.bestColor(owner), 0};
+    count    = 1;
+  }
+
+  return count;
+}
+
+int evaluate(const RegionGraph &graph, const Owner &owner) noexcept
+{
+  return graph.count(owner) - graph.count(opponentOf(owner));
+}
+
+int finalScore(const std::array<int, static_cast<int>(Owner::Count)> &finals,
+               const Owner &owner) noexcept
+{
+  return finals[static_cast<int>(owner)] - finals[static_cast<int>(opponentOf(owner))];
+}
+
+} // namespace pge::ai
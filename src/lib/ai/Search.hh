@@ -0,0 +1,66 @@
+
+#pragma once
+
+#include "RegionGraph.hh"
+#include <array>
+
+namespace pge::ai {
+
+/// @brief - A color which can be picked, along with the number of cells it
+/// brings right away.
+struct Move
+{
+  Color color;
+  int gain;
+};
+
+/// @brief - A list of moves with a fixed capacity, so that generating moves
+/// during a search does not allocate.
+using Moves = std::array<Move, static_cast<int>(Color::Count)>;
+
+/// @brief - The outcome of a search.
+struct SearchResult
+{
+  // The color to play.
+  Color color;
+
+  // The score of the position when playing this color, from the point of
+  // view of the owner playing it. Its scale depends on the engine.
+  int score;
+
+  // The amount of work done by the search, such as the number of positions
+  // it visited.
+  int nodes;
+
+  // The number of moves explored ahead, or `0` for engines which don't
+  // search by depth.
+  int depth;
+};
+
+/// @brief - Generates the colors an owner can pick, sorted by decreasing
+/// gain. The colors which don't bring any cell are dropped, unless none of
+/// the colors brings any cell: in this case the one of `bestColor` is kept
+/// as the owner still has to pick a color. The first move is always the
+/// one of `bestColor`.
+/// @param graph - the state of the game.
+/// @param owner - the owner picking a color.
+/// @param moves - output list of moves.
+/// @return - the number of moves generated.
+int generateMoves(const RegionGraph &graph, const Owner &owner, Moves &moves) noexcept;
+
+/// @brief - The score of a state for an owner: the difference between its
+/// number of cells and the one of its opponent.
+/// @param graph - the state of the game.
+/// @param owner - the owner for which the state is evaluated.
+/// @return - the score of the state.
+int evaluate(const RegionGraph &graph, const Owner &owner) noexcept;
+
+/// @brief - The score of a decided game for an owner, as `evaluate` does
+/// for the current state.
+/// @param finals - the number of cells of each owner at the end of the game.
+/// @param owner - the owner for which the game is evaluated.
+/// @return - the final score of the game.
+int finalScore(const std::array<int, static_cast<int>(Owner::Count)> &finals,
+               const Owner &owner) noexcept;
+
+} // namespace pge::ai
@@ -0,0 +1,124 @@
+
+#include "ThreadPool.hh"
+#include <algorithm>
+
+namespace pge::ai {
+
+ThreadPool::ThreadPool(int threads)
+{
+  const auto count = std::max(threads, 1);
+
+  for (auto id = 0; id < count; ++id)
+  {
+    m_queues.push_back(std::make_unique<Queue>());
+  }
+  for (auto id = 0; id < count; ++id)
+  {
+    m_threads.emplace_back([this, id]() { run(id); });
+  }
+}
+
+ThreadPool::~ThreadPool()
+{
+  {
+    std::lock_guard<std::mutex> guard(m_lock);
+    m_stop = true;
+  }
+
+  m_wakeUp.notify_all();
+  for (auto &thread : m_threads)
+  {
+    thread.join();
+  }
+}
+
+int ThreadPool::size() const noexcept
+{
+  return static_cast<int>(m_threads.size());
+}
+
+void ThreadPool::push(Task task)
+{
+  std::unique_lock<std::mutex> guard(m_lock);
+  auto &queue = *m_queues[m_next % m_queues.size()];
+  ++m_next;
+  ++m_pending;
+  guard.unlock();
+
+  {
+    std::lock_guard<std::mutex> queueGuard(queue.lock);
+    queue.tasks.push_back(std::move(task));
+  }
+
+  m_wakeUp.notify_one();
+}
+
+bool ThreadPool::pop(int thread, Task &task)
+{
+  const auto count = static_cast<int>(m_queues.size());
+
+  for (auto id = 0; id < count; ++id)
+  {
+    auto &queue = *m_queues[(thread + id) % count];
+    std::lock_guard<std::mutex> queueGuard(queue.lock);
+    if (queue.tasks.empty())
+    {
+      continue;
+    }
+
+    // The own queue of the thread is processed from the back while other
+    // queues are stolen from the front.
+    if (id == 0)
+    {
+      task = std::move(queue.tasks.back());
+      queue.tasks.pop_back();
+    }
+    else
+    {
+      task = std::move(queue.tasks.front());
+      queue.tasks.pop_front();
+    }
+
+    return true;
+  }
+
+  return false;
+}
+
+void ThreadPool::run(int thread)
+{
+  Task task;
+
+  while (true)
+  {
+    {
+      std::unique_lock<std::mutex> guard(m_lock);
+      m_wakeUp.wait(guard, [this]() { return m_stop || m_pending > 0; });
+      if (m_pending == 0)
+      {
+        return;
+      }
+
+      // Reserve a task: it may be pushed in a queue slightly after the
+      // counter was incremented, in which case the loop below retries.
+      --m_pending;
+    }
+
+    while (!pop(thread, task))
+    {
+      std::this_thread::yield();
+    }
+
+    task();
+    task = nullptr;
+  }
+}
+
+auto sharedThreadPool() -> ThreadPoolShPtr
+{
+  static const auto pool = std::make_shared<ThreadPool>(
+    static_cast<int>(std::thread::hardware_concurrency()));
+  return pool;
+}
+
+} // namespace pge::ai
@@ -0,0 +1,82 @@
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace pge::ai {
+
+/// @brief - A pool of threads executing tasks. Each thread owns a queue of
+/// tasks which it processes from the back, and steals tasks from the front
+/// of the queues of the other threads when its own is empty: this keeps
+/// all the threads busy when tasks have uneven durations, which is the
+/// case of searches starting from different moves.
+class ThreadPool
+{
+  public:
+  /// @brief - Create a pool with the specified number of threads.
+  /// @param threads - the number of threads, at least one is created.
+  ThreadPool(int threads);
+
+  /// @brief - Waits for the tasks already submitted and joins the threads.
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+
+  /// @brief - The number of threads of the pool.
+  /// @return - the number of threads.
+  int size() const noexcept;
+
+  /// @brief - Schedules a function for execution on one of the threads.
+  /// @param func - the function to execute.
+  /// @return - a future holding the result of the function.
+  template <typename Func>
+  auto submit(Func &&func) -> std::future<std::invoke_result_t<Func>>;
+
+  private:
+  using Task = std::function<void()>;
+
+  /// @brief - The tasks assigned to a thread.
+  struct Queue
+  {
+    std::mutex lock{};
+    std::deque<Task> tasks{};
+  };
+
+  std::vector<std::unique_ptr<Queue>> m_queues{};
+  std::vector<std::thread> m_threads{};
+
+  /// @brief - Protects the number of pending tasks and the stop flag, which
+  /// the threads wait on when they have nothing to do.
+  std::mutex m_lock{};
+  std::condition_variable m_wakeUp{};
+  int m_pending{0};
+  bool m_stop{false};
+
+  /// @brief - The queue receiving the next task, so that tasks are spread
+  /// over the threads.
+  unsigned m_next{0u};
+
+  void push(Task task);
+  bool pop(int thread, Task &task);
+  void run(int thread);
+};
+
+using ThreadPoolShPtr = std::shared_ptr<ThreadPool>;
+
+/// @brief - Returns a pool shared by all the engines, with as many threads
+/// as the machine has cores.
+/// @return - the shared pool.
+auto sharedThreadPool() -> ThreadPoolShPtr;
+
+} // namespace pge::ai
+
+#include "ThreadPool.hxx"
@@ -0,0 +1,23 @@
+
+#pragma once
+
+#include "ThreadPool.hh"
+
+namespace pge::ai {
+
+template <typename Func>
+inline auto ThreadPool::submit(Func &&func) -> std::future<std::invoke_result_t<Func>>
+{
+  using Result = std::invoke_result_t<Func>;
+
+  // Tasks are stored as copyable functions: the packaged task which is not
+  // copyable is shared with the wrapper.
+  auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<Func>(func));
+  auto out  = task->get_future();
+
+  push([task]() { (*task)(); });
+
+  return out;
+}
+
+} // namespace pge::ai
@@ -0,0 +1,95 @@
+
+#include "TranspositionTable.hh"
+
+namespace pge::ai {
+namespace {
+
+/// @brief - Packs an entry in a 64-bit word: the score takes the low 32
+/// bits, followed by the depth, the bound and the move. A valid packed
+/// entry is never `0` as the depth is always positive.
+auto pack(const TableEntry &entry) noexcept -> std::uint64_t
+{
+  return static_cast<std::uint64_t>(static_cast<std::uint32_t>(entry.score))
+         | (static_cast<std::uint64_t>(entry.depth & 0xFFFF) << 32)
+         | (static_cast<std::uint64_t>(entry.bound) << 48)
+         | (static_cast<std::uint64_t>(entry.move) << 56);
+}
+
+auto unpack(std::uint64_t data) noexcept -> TableEntry
+{
+  return TableEntry{
+    static_cast<int>(static_cast<std::uint32_t>(data & 0xFFFFFFFFu)),
+    static_cast<int>((data >> 32) & 0xFFFFu),
+    static_cast<Bound>((data >> 48) & 0xFFu),
+    static_cast<Color>((data >> 56) & 0xFFu),
+  };
+}
+
+} // namespace
+
+TranspositionTable::TranspositionTable(int bits)
+  : m_mask((std::uint64_t{1u} << bits) - 1u)
+  , m_slots(std::make_unique<Slot[]>(m_mask + 1u))
+{}
+
+int TranspositionTable::size() const noexcept
+{
+  return static_cast<int>(m_mask + 1u);
+}
+
+bool TranspositionTable::probe(std::uint64_t hash, TableEntry &entry) const noexcept
+{
+  const auto &slot = m_slots[hash & m_mask];
+
+  const auto data = slot.data.load(std::memory_order_relaxed);
+  if (data == 0u || (slot.check.load(std::memory_order_relaxed) ^ data) != hash)
+  {
+    return false;
+  }
+
+  entry = unpack(data);
+  return true;
+}
+
+void TranspositionTable::store(std::uint64_t hash, const TableEntry &entry) noexcept
+{
+  auto &slot = m_slots[hash & m_mask];
+
+  const auto old = slot.data.load(std::memory_order_relaxed);
+  if (old != 0u && (slot.check.load(std::memory_order_relaxed) ^ old) == hash
+      && unpack(old).depth > entry.depth)
+  {
+    return;
+  }
+
+  const auto data = pack(entry);
+  slot.check.store(hash ^ data, std::memory_order_relaxed);
+  slot.data.store(data, std::memory_order_relaxed);
+}
+
+void TranspositionTable::clear() noexcept
+{
+  for (auto id = 0u; id <= m_mask; ++id)
+  {
+    m_slots[id].check.store(0u, std::memory_order_relaxed);
+    m_slots[id].data.store(0u, std::memory_order_relaxed);
+  }
+}
+
+auto TranspositionTable::fingerprint() const noexcept -> std::uint64_t
+{
+  return m_fingerprint;
+}
+
+void TranspositionTable::attach(std::uint64_t fingerprint) noexcept
+{
+  if (m_attached && fingerprint != m_fingerprint)
+  {
+    clear();
+  }
+
+  m_fingerprint = fingerprint;
+  m_attached    = true;
+}
+
+} // namespace pge::ai
@@ -0,0 +1,98 @@
+
+#pragma once
+
+#include "Cell.hh"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+namespace pge::ai {
+
+/// @brief - How the score stored for a position relates to its real score.
+enum class Bound
+{
+  Exact,
+  Lower,
+  Upper
+};
+
+/// @brief - The result of the search of a position.
+struct TableEntry
+{
+  int score;
+
+  // The number of moves which were explored ahead of the position.
+  int depth;
+
+  Bound bound;
+
+  // The best color found for the position.
+  Color move;
+};
+
+/// @brief - A fixed size table of search results indexed by the hash of
+/// the positions, shared by all the threads of a search without locks.
+/// Each slot stores the packed entry along with the hash xored with it:
+/// a slot written concurrently by two threads yields a mismatching hash
+/// and is ignored, instead of returning a torn entry.
+/// Entries are replaced when a different position lands in their slot or
+/// when the same position is searched at least as deep.
+/// The table holds the positions of a single board at a time, identified by
+/// its fingerprint: it is emptied when it is used for another board.
+class TranspositionTable
+{
+  public:
+  /// @brief - Create a table with a number of slots equal to a power of two.
+  /// @param bits - the number of bits of the hash used to index the table.
+  TranspositionTable(int bits);
+
+  /// @brief - The number of slots of the table.
+  /// @return - the number of slots.
+  int size() const noexcept;
+
+  /// @brief - Looks for the entry of a position.
+  /// @param hash - the hash of the position.
+  /// @param entry - output entry, only set when the position is found.
+  /// @return - `true` if the position is found.
+  bool probe(std::uint64_t hash, TableEntry &entry) const noexcept;
+
+  /// @brief - Saves the result of the search of a position.
+  /// @param hash - the hash of the position.
+  /// @param entry - the result of the search.
+  void store(std::uint64_t hash, const TableEntry &entry) noexcept;
+
+  /// @brief - Removes all the entries of the table.
+  void clear() noexcept;
+
+  /// @brief - The fingerprint of the board whose positions are stored in
+  /// the table.
+  auto fingerprint() const noexcept -> std::uint64_t;
+
+  /// @brief - Prepares the table to store the positions of a board. The
+  /// entries of another board are removed: the hashes of its positions are
+  /// not related to the ones of this board. This should not be called while
+  /// a search uses the table. The entries stored before the table is first
+  /// attached are considered to belong to the first board.
+  /// @param fingerprint - the fingerprint of the board, as computed by the
+  /// graph of its regions.
+  void attach(std::uint64_t fingerprint) noexcept;
+
+  private:
+  struct Slot
+  {
+    std::atomic<std::uint64_t> check{0u};
+    std::atomic<std::uint64_t> data{0u};
+  };
+
+  std::uint64_t m_mask;
+  std::unique_ptr<Slot[]> m_slots;
+
+  std::uint64_t m_fingerprint{0u};
+
+  /// @brief - Whether the table was attached to a board.
+  bool m_attached{false};
+};
+
+using TranspositionTableShPtr = std::shared_ptr<TranspositionTable>;
+
+} // namespace pge::ai
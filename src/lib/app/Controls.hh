@@ -18,8 +18,10 @@ enum Keys
 
   Space,
 
+  A,
   P,
   S,
+  U,
 
   KeysCount
 };
@@ -209,12 +209,18 @@ PGEApp::InputChanges PGEApp::handleInputs()
   b                                      = GetKey(olc::SPACE);
   m_controls.keys[controls::keys::Space] = b.bPressed || b.bHeld;
 
+  b                                  = GetKey(olc::A);
+  m_controls.keys[controls::keys::A] = b.bReleased;
+
   b                                  = GetKey(olc::P);
   m_controls.keys[controls::keys::P] = b.bReleased;
 
   b                                  = GetKey(olc::S);
   m_controls.keys[controls::keys::S] = b.bReleased;
 
+  b                                  = GetKey(olc::U);
+  m_controls.keys[controls::keys::U] = b.bReleased;
+
   b = GetKey(olc::TAB), m_controls.tab = b.bReleased;
 
   auto analysis = [](const olc::HWButton &b) {
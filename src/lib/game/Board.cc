@@ -1,15 +1,53 @@
 
 #include "Board.hh"
+#include "Random.hh"
+#include <algorithm>
+#include <array>
 #include <fstream>
-#include <unordered_map>
-#include <unordered_set>
+#include <thread>
+#include <vector>
 
 namespace pge {
+namespace {
+
+/// @brief - Starts the files where each cell is packed in a single byte.
+/// Older files start directly with the dimensions of the board and store
+/// the owner and the color of each cell on 4 bytes each: no board is wide
+/// enough to be mistaken for this value.
+constexpr auto PACKED_SAVE_MAGIC = 0x31435053u;
+
+/// @brief - Starts the files where the cells are saved as a quadtree.
+constexpr auto QUADTREE_SAVE_MAGIC = 0x31545153u;
+
+/// @brief - Starts the files of chunked boards: the dimensions of the whole
+/// board come first, followed by the generated part saved in one of the
+/// other formats.
+constexpr auto CHUNKED_SAVE_MAGIC = 0x31484353u;
+
+/// @brief - Boards with at least this number of cells are generated from
+/// several threads: below that, starting the threads costs more than what
+/// they save.
+constexpr auto PARALLEL_GENERATION_MIN_CELLS = 1 << 20;
+
+/// @brief - The value of a cell in the quadtree of the board: owned cells
+/// only keep their owner, so that a territory stays uniform as its owner
+/// changes color.
+auto blockOf(const Cell &cell) noexcept -> QuadTree::Value
+{
+  const auto owned = (cell.owner != Owner::Nobody);
+  return PackedCells::pack(owned ? Cell{cell.owner, Color::Red} : cell);
+}
+
+} // namespace
 
-Board::Board(int width, int height)
+Board::Board(int width, int height, std::uint64_t seed, const Generation &generation)
   : utils::CoreObject("board")
   , m_width(width)
   , m_height(height)
+  , m_fullWidth(width)
+  , m_fullHeight(height)
+  , m_generation(generation)
+  , m_seed(seed)
 {
   setService("square");
   if (m_width <= 0 || m_height <= 0)
@@ -18,6 +56,19 @@ Board::Board(int width, int height)
           "Invalid dimensions " + std::to_string(m_width) + "x" + std::to_string(m_height));
   }
 
+  if (m_generation == Generation::Chunked)
+  {
+    if (static_cast<long>(m_width) * m_height > MAX_CHUNKED_CELLS)
+    {
+      error("Failed to initialize board",
+            "Too many cells for chunked board " + std::to_string(m_width) + "x"
+              + std::to_string(m_height));
+    }
+
+    m_width  = std::min(m_width, CHUNK_DIMS);
+    m_height = std::min(m_height, CHUNK_DIMS);
+  }
+
   initialize();
 }
 
@@ -31,6 +82,26 @@ int Board::height() const noexcept
   return m_height;
 }
 
+int Board::fullWidth() const noexcept
+{
+  return m_fullWidth;
+}
+
+int Board::fullHeight() const noexcept
+{
+  return m_fullHeight;
+}
+
+auto Board::generation() const noexcept -> Generation
+{
+  return m_generation;
+}
+
+auto Board::seed() const noexcept -> std::uint64_t
+{
+  return m_seed;
+}
+
 Cell Board::at(int x, int y) const
 {
   if (x < 0 || x >= m_width || y < 0 || y >= m_height)
@@ -39,7 +110,11 @@ Cell Board::at(int x, int y) const
           "Invalid coordinates " + std::to_string(x) + "x" + std::to_string(y));
   }
 
-  return m_cells[linear(x, y)];
+  Cell out{};
+  out.owner = ownerAt(x, y);
+  out.color = (out.owner == Owner::Nobody ? colorAt(x, y) : m_regions.color(out.owner));
+
+  return out;
 }
 
 auto Board::colorOf(const Owner &owner) const noexcept -> Color
@@ -47,9 +122,8 @@ auto Board::colorOf(const Owner &owner) const noexcept -> Color
   switch (owner)
   {
     case Owner::Player:
-      return at(0, 0).color;
     case Owner::AI:
-      return at(width() - 1, height() - 1).color;
+      return m_regions.color(owner);
     default:
       error("Can't determine color", "Invalid owner " + std::to_string(static_cast<int>(owner)));
   }
@@ -60,169 +134,135 @@ auto Board::colorOf(const Owner &owner) const noexcept -> Color
 
 bool Board::isPlayerAndAiInContact() const noexcept
 {
-  for (auto y = 0; y < height(); ++y)
-  {
-    for (auto x = 0; x < width(); ++x)
-    {
-      const auto c = m_cells[linear(x, y)];
-      if (c.owner != Owner::Player)
-      {
-        continue;
-      }
-
-      if (hasBorderWith(x, y, Owner::AI))
-      {
-        return true;
-      }
-    }
-  }
-
-  return false;
+  return m_regions.inContact();
 }
 
 float Board::occupiedBy(const Owner &owner) const noexcept
 {
-  return 1.0f * countFor(owner) / m_cells.size();
+  return 1.0f * countFor(owner) / (static_cast<float>(m_fullWidth) * m_fullHeight);
 }
 
 void Board::changeColorOf(const Owner &owner, const Color &color) noexcept
 {
-  std::for_each(m_cells.begin(), m_cells.end(), [&owner, &color](Cell &c) {
-    if (c.owner == owner)
-    {
-      c.color = color;
-    }
-  });
+  const auto gained = apply(owner, color);
+  expand();
 
-  auto gained = 0;
-  for (auto y = 0; y < height(); ++y)
+  debug(ownerName(owner) + " gained " + std::to_string(gained) + " cell(s)");
+  updateStatus();
+}
+
+void Board::complete(const Owner &next) noexcept
+{
+  if (m_status == Status::Running)
   {
-    for (auto x = 0; x < width(); ++x)
-    {
-      auto &c = m_cells[linear(x, y)];
-      if (c.owner == Owner::Nobody && c.color == color && hasBorderWith(x, y, owner))
-      {
-        c.owner = owner;
-        ++gained;
-      }
-    }
+    warn("Failed to complete board", "Outcome of the game is not decided yet");
+    return;
   }
 
-  debug(ownerName(owner) + " gained " + std::to_string(gained) + " cell(s)");
+  // Both owners pick in turn the color bringing the most cells. An owner
+  // which can't gain anything still changes its color, which may unblock
+  // the other owner when their territories are in contact.
+  auto owner = next;
+  auto moves = 0;
+  while (m_regions.contested() > 0)
+  {
+    apply(owner, bestColorFor(owner));
+    owner = opponentOf(owner);
+    ++moves;
+  }
+
+  debug("Completed board with " + std::to_string(moves) + " move(s)");
   updateStatus();
 }
 
-auto Board::bestColorFor(const Owner &owner) const noexcept -> Color
+int Board::history() const noexcept
 {
-  struct Gain
-  {
-    Color color;
-    int amount;
-  };
-  std::vector<Gain> gainPerColor(static_cast<int>(Color::Count));
-  const auto otherColor   = colorOf(owner == Owner::AI ? Owner::Player : Owner::AI);
-  const auto areInContact = isPlayerAndAiInContact();
-
-  std::unordered_set<std::string> usedGains;
-  bool zeroGain        = true;
-  const auto validCell = [this](const int x, const int y) {
-    return x >= 0 && y >= 0 && x < m_width && y < m_height;
-  };
-  const auto toKey = [](const int x, const int y) {
-    return std::to_string(x) + "x" + std::to_string(y);
-  };
-  const auto isGainForColor = [&usedGains, &toKey, this](const int x, const int y, const Color &c) {
-    if (usedGains.count(toKey(x, y)) > 0)
-    {
-      return false;
-    }
+  return static_cast<int>(m_moves.size());
+}
 
-    return m_cells[linear(x, y)].owner == Owner::Nobody && m_cells[linear(x, y)].color == c;
-  };
+auto Board::undo() noexcept -> Owner
+{
+  if (m_moves.empty())
+  {
+    warn("Failed to undo move", "No move to undo");
+    return Owner::Nobody;
+  }
 
-  const auto accumulateGain =
-    [&validCell, &isGainForColor, &gainPerColor, &usedGains, &toKey, this](const int x,
-                                                                           const int y,
-                                                                           const int cId) {
-      if (validCell(x, y) && isGainForColor(x, y, static_cast<Color>(cId)))
-      {
-        ++gainPerColor[cId].amount;
-      }
-      usedGains.insert(toKey(x, y));
-    };
+  m_absorbed.clear();
+  const auto owner = m_regions.undo(m_absorbed);
 
-  for (auto cId = 0u; cId < gainPerColor.size(); ++cId)
+  // The colors were not modified when the cells were absorbed: only the
+  // owners need to be restored.
+  const auto start = m_moves.back().start;
+  for (auto id = start; id < static_cast<int>(m_cells.size()); ++id)
   {
-    gainPerColor[cId].color  = static_cast<Color>(cId);
-    gainPerColor[cId].amount = 0;
+    m_grid.setOwner(m_cells[id], Owner::Nobody);
+  }
+  updateQuadTree(start);
 
-    if (gainPerColor[cId].color == otherColor && areInContact)
-    {
-      debug("Ignoring " + colorName(gainPerColor[cId].color) + ", opponent has this color");
-      continue;
-    }
+  debug(ownerName(owner) + " released " + std::to_string(m_cells.size() - start) + " cell(s)");
 
-    for (auto y = 0; y < m_height; ++y)
-    {
-      for (auto x = 0; x < m_width; ++x)
-      {
-        const auto &cell = m_cells[linear(x, y)];
+  m_cells.resize(start);
+  m_moves.pop_back();
+  updateStatus();
 
-        if (cell.owner != owner)
-        {
-          continue;
-        }
+  return owner;
+}
 
-        accumulateGain(x, y + 1, cId);
-        accumulateGain(x, y - 1, cId);
-        accumulateGain(x - 1, y, cId);
-        accumulateGain(x + 1, y, cId);
-      }
-    }
+auto Board::bestColorFor(const Owner &owner) const noexcept -> Color
+{
+  return m_regions.bestColor(owner);
+}
 
-    debug("Gain for " + colorName(gainPerColor[cId].color) + " is "
-          + std::to_string(gainPerColor[cId].amount));
-    usedGains.clear();
-    zeroGain &= (gainPerColor[cId].amount == 0);
-  }
+auto Board::status() const noexcept -> Status
+{
+  return m_status;
+}
 
-  std::sort(gainPerColor.begin(), gainPerColor.end(), [](const Gain &lhs, const Gain &rhs) {
-    return lhs.amount > rhs.amount;
-  });
+auto Board::regions() const noexcept -> const RegionGraph &
+{
+  return m_regions;
+}
+
+auto Board::hash() const noexcept -> std::uint64_t
+{
+  return m_regions.hash();
+}
 
-  if (zeroGain)
+void Board::useQuadTree(bool enable)
+{
+  if (!enable)
   {
-    // Random color.
-    Color pick                            = otherColor;
-    constexpr auto TRIES_FOR_RANDOM_COLOR = static_cast<int>(Color::Count);
-    auto tries                            = 0;
-    while (pick == otherColor && tries < TRIES_FOR_RANDOM_COLOR)
-    {
-      pick = static_cast<Color>(std::rand() % static_cast<int>(Color::Count));
-      ++tries;
-    }
+    m_tree.reset();
+    return;
+  }
 
-    if (pick == otherColor)
-    {
-      warn("Failed to pick a random color, continuing with first one");
-    }
-    else
-    {
-      return pick;
-    }
+  if (!m_tree)
+  {
+    m_tree.emplace();
+    buildQuadTree();
   }
+}
 
-  return gainPerColor.front().color;
+auto Board::quadTree() const noexcept -> const QuadTree *
+{
+  return (m_tree ? &*m_tree : nullptr);
 }
 
-auto Board::status() const noexcept -> Status
+auto Board::cellOf(QuadTree::Value value) const noexcept -> Cell
 {
-  return m_status;
+  auto out = PackedCells::unpack(value);
+  if (out.owner != Owner::Nobody)
+  {
+    out.color = m_regions.color(out.owner);
+  }
+
+  return out;
 }
 
 void Board::save(const std::string &file) const noexcept
 {
-  std::ofstream out(file.c_str());
+  std::ofstream out(file.c_str(), std::ios::binary);
   if (!out.good())
   {
     error("Failed to save board to \"" + file + "\"", "Failed to open file");
@@ -231,19 +271,70 @@ void Board::save(const std::string &file) const noexcept
   unsigned buf, size = sizeof(unsigned);
   const char *raw = reinterpret_cast<const char *>(&buf);
 
+  if (m_generation == Generation::Chunked)
+  {
+    buf = CHUNKED_SAVE_MAGIC;
+    out.write(raw, size);
+
+    buf = m_fullWidth;
+    out.write(raw, size);
+
+    buf = m_fullHeight;
+    out.write(raw, size);
+  }
+
+  buf = (m_tree ? QUADTREE_SAVE_MAGIC : PACKED_SAVE_MAGIC);
+  out.write(raw, size);
+
   buf = m_width;
   out.write(raw, size);
 
   buf = m_height;
   out.write(raw, size);
 
-  for (const auto &c : m_cells)
+  out.write(reinterpret_cast<const char *>(&m_seed), sizeof(m_seed));
+
+  if (m_tree)
   {
-    buf = static_cast<unsigned>(c.owner);
-    out.write(raw, size);
+    // The tree only keeps the owner of the owned cells: the colors of the
+    // owners come first.
+    for (const auto &owner : {Owner::Player, Owner::AI})
+    {
+      buf = static_cast<unsigned>(m_regions.color(owner));
+      out.write(raw, size);
+    }
 
-    buf = static_cast<unsigned>(c.color);
-    out.write(raw, size);
+    m_tree->save(out);
+
+    info("Saved " + std::to_string(m_tree->nodes()) + " node(s) of board with dimensions "
+         + std::to_string(m_width) + "x" + std::to_string(m_height) + " to \"" + file + "\"");
+    return;
+  }
+
+  // The grid keeps the color of the owned cells as they were when absorbed:
+  // they are replaced by the current color of their owner.
+  std::array<std::uint8_t, 1u << PackedCells::SLICES> current{};
+  for (auto id = 0u; id < current.size(); ++id)
+  {
+    auto c = PackedCells::unpack(static_cast<std::uint8_t>(id));
+    if (c.owner == Owner::Player || c.owner == Owner::AI)
+    {
+      c.color = m_regions.color(c.owner);
+    }
+
+    current[id] = PackedCells::pack(c);
+  }
+
+  std::vector<std::uint8_t> row(m_width);
+  for (auto y = 0; y < m_height; ++y)
+  {
+    m_grid.storeRow(y, row.data());
+    for (auto &packed : row)
+    {
+      packed = current[packed];
+    }
+
+    out.write(reinterpret_cast<const char *>(row.data()), m_width);
   }
 
   info("Saved content of board with dimensions " + std::to_string(m_width) + "x"
@@ -252,215 +343,468 @@ void Board::save(const std::string &file) const noexcept
 
 void Board::load(const std::string &file)
 {
-  std::ifstream out(file.c_str());
+  std::ifstream out(file.c_str(), std::ios::binary);
   if (!out.good())
   {
     error("Failed to load board to \"" + file + "\"", "Failed to open file");
   }
 
-  out.read(reinterpret_cast<char *>(&m_width), sizeof(unsigned));
+  unsigned buf, size = sizeof(unsigned);
+  char *raw = reinterpret_cast<char *>(&buf);
+
+  out.read(raw, size);
+
+  // Chunked boards start with the dimensions of the whole board.
+  auto generation = Generation::Eager;
+  std::array<int, 2> full{};
+  if (buf == CHUNKED_SAVE_MAGIC)
+  {
+    generation = Generation::Chunked;
+    out.read(reinterpret_cast<char *>(full.data()), 2 * sizeof(unsigned));
+    out.read(raw, size);
+  }
+
+  const auto format = buf;
+  const auto legacy = (format != PACKED_SAVE_MAGIC && format != QUADTREE_SAVE_MAGIC);
+  if (legacy && generation == Generation::Chunked)
+  {
+    error("Failed to load board from file \"" + file + "\"", "Invalid format for chunked board");
+  }
+  if (!legacy)
+  {
+    out.read(raw, size);
+  }
+
+  m_width = buf;
   out.read(reinterpret_cast<char *>(&m_height), sizeof(unsigned));
 
-  if (m_width == 0u || m_height == 0u)
+  if (!out.good() || m_width <= 0 || m_height <= 0)
   {
     error("Failed to load board from file \"" + file + "\"",
           "Invalid board of size " + std::to_string(m_width) + "x" + std::to_string(m_height));
   }
 
-  m_cells.resize(m_width * m_height);
+  if (generation == Generation::Eager)
+  {
+    full = {m_width, m_height};
+  }
+  else if (full[0] < m_width || full[1] < m_height
+      || static_cast<long>(full[0]) * full[1] > MAX_CHUNKED_CELLS)
+  {
+    error("Failed to load board from file \"" + file + "\"",
+          "Invalid chunked board of size " + std::to_string(full[0]) + "x"
+            + std::to_string(full[1]));
+  }
 
-  unsigned buf, size = sizeof(unsigned);
-  char *raw = reinterpret_cast<char *>(&buf);
-  for (unsigned id = 0u; id < m_cells.size(); ++id)
+  m_generation = generation;
+  m_fullWidth  = full[0];
+  m_fullHeight = full[1];
+
+  // Legacy files do not store the seed: the current one is kept.
+  if (!legacy)
   {
-    auto &c = m_cells[id];
+    out.read(reinterpret_cast<char *>(&m_seed), sizeof(m_seed));
+    if (!out.good())
+    {
+      error("Failed to load board from file \"" + file + "\"", "Missing seed");
+    }
+  }
 
-    out.read(raw, size);
-    c.owner = static_cast<Owner>(buf);
+  resize();
 
-    out.read(raw, size);
-    c.color = static_cast<Color>(buf);
+  if (format == QUADTREE_SAVE_MAGIC)
+  {
+    loadQuadTree(out, file);
+  }
+  else
+  {
+    loadRows(out, file, legacy);
   }
 
+  buildRegions();
+  buildQuadTree();
   updateStatus();
 
   info("Loaded board with dimensions " + std::to_string(m_width) + "x" + std::to_string(m_height));
 }
 
-void Board::initialize()
+void Board::loadRows(std::istream &in, const std::string &file, bool legacy)
 {
-  m_cells.resize(m_width * m_height);
+  unsigned buf, size = sizeof(unsigned);
+  char *raw = reinterpret_cast<char *>(&buf);
 
-  for (auto &cell : m_cells)
+  std::vector<std::uint8_t> row(m_width);
+  for (auto y = 0; y < m_height; ++y)
   {
-    cell.color = generateRandomColor();
+    if (!legacy)
+    {
+      in.read(reinterpret_cast<char *>(row.data()), m_width);
+      if (in.gcount() != m_width)
+      {
+        error("Failed to load board from file \"" + file + "\"",
+              "Missing cells in row " + std::to_string(y));
+      }
+      if (!m_grid.loadRow(y, row.data()))
+      {
+        error("Failed to load board from file \"" + file + "\"",
+              "Invalid cell in row " + std::to_string(y));
+      }
+
+      continue;
+    }
+
+    for (auto x = 0; x < m_width; ++x)
+    {
+      Cell c;
+
+      in.read(raw, size);
+      c.owner = static_cast<Owner>(buf);
+
+      in.read(raw, size);
+      c.color = static_cast<Color>(buf);
+
+      if (!in.good() || c.owner >= Owner::Count || c.color >= Color::Count)
+      {
+        error("Failed to load board from file \"" + file + "\"",
+              "Invalid cell at " + std::to_string(x) + "x" + std::to_string(y));
+      }
+
+      assign(x, y, c);
+    }
   }
+}
 
-  auto &player          = m_cells[linear(0, 0)];
-  player.owner          = Owner::Player;
-  m_cells[linear(1, 0)] = player;
-  m_cells[linear(1, 1)] = player;
-  m_cells[linear(0, 1)] = player;
+void Board::loadQuadTree(std::istream &in, const std::string &file)
+{
+  unsigned buf, size = sizeof(unsigned);
+  char *raw = reinterpret_cast<char *>(&buf);
 
-  auto &ai = m_cells[linear(width() - 1, height() - 1)];
-  ai.owner = Owner::AI;
-  while (player.color == ai.color)
+  std::array<Color, static_cast<int>(Owner::Count)> colors{};
+  for (const auto &owner : {Owner::Player, Owner::AI})
   {
-    ai.color = generateRandomColor();
+    in.read(raw, size);
+    if (!in.good() || buf >= static_cast<unsigned>(Color::Count))
+    {
+      error("Failed to load board from file \"" + file + "\"",
+            "Invalid color for " + ownerName(owner));
+    }
+
+    colors[static_cast<int>(owner)] = static_cast<Color>(buf);
+  }
+
+  QuadTree tree;
+  if (!tree.load(in, m_width, m_height))
+  {
+    error("Failed to load board from file \"" + file + "\"", "Invalid quadtree");
+  }
+
+  auto valid = true;
+  tree.visit([this, &colors, &valid](const int x, const int y, const int size, const QuadTree::Value value) {
+    auto c = PackedCells::unpack(value);
+    if (value >= (1u << PackedCells::SLICES) || c.owner >= Owner::Count)
+    {
+      valid = false;
+      return;
+    }
+
+    if (c.owner != Owner::Nobody)
+    {
+      c.color = colors[static_cast<int>(c.owner)];
+    }
+
+    for (auto cy = y; cy < y + size; ++cy)
+    {
+      for (auto cx = x; cx < x + size; ++cx)
+      {
+        assign(cx, cy, c);
+      }
+    }
+  });
+
+  if (!valid)
+  {
+    error("Failed to load board from file \"" + file + "\"", "Invalid cell in quadtree");
   }
-  m_cells[linear(width() - 1, height() - 2)] = ai;
-  m_cells[linear(width() - 2, height() - 2)] = ai;
-  m_cells[linear(width() - 2, height() - 1)] = ai;
 }
 
-int Board::linear(int x, int y) const noexcept
+void Board::initialize()
 {
-  return y * width() + x;
+  resize();
+
+  generate();
+
+  const Cell player{Owner::Player, colorAt(0, 0)};
+  assign(0, 0, player);
+  assign(1, 0, player);
+  assign(1, 1, player);
+  assign(0, 1, player);
+
+  Cell ai{Owner::AI, colorAt(width() - 1, height() - 1)};
+  if (player.color == ai.color)
+  {
+    ai.color = static_cast<Color>((static_cast<int>(ai.color) + 1) % static_cast<int>(Color::Count));
+  }
+  assign(width() - 1, height() - 1, ai);
+  assign(width() - 1, height() - 2, ai);
+  assign(width() - 2, height() - 2, ai);
+  assign(width() - 2, height() - 1, ai);
+
+  buildRegions();
+  buildQuadTree();
+  expand();
 }
 
-bool Board::hasBorderWith(int x, int y, const Owner &owner) const noexcept
+void Board::generate()
 {
-  const auto w         = width();
-  const auto h         = height();
-  const auto validCell = [&w, &h](const int x, const int y) {
-    return x >= 0 && y >= 0 && x < w && y < h;
-  };
+  if (m_generation == Generation::Chunked)
+  {
+    std::vector<std::uint8_t> bytes(m_width);
+    for (auto y = 0; y < m_height; ++y)
+    {
+      generateSpan(y, 0, m_width, bytes.data());
+      m_grid.loadRow(y, bytes.data());
+    }
 
-  const auto top    = linear(x, y + 1);
-  const auto bottom = linear(x, y - 1);
-  const auto left   = linear(x - 1, y);
-  const auto right  = linear(x + 1, y);
+    return;
+  }
 
-  if (validCell(x, y + 1) && m_cells[top].owner == owner)
+  const auto cells   = static_cast<long>(m_width) * m_height;
+  const auto threads = static_cast<int>(std::thread::hardware_concurrency());
+  if (cells < PARALLEL_GENERATION_MIN_CELLS || threads <= 1)
   {
-    return true;
+    generateRows(0, m_height);
+    return;
   }
-  if (validCell(x, y - 1) && m_cells[bottom].owner == owner)
+
+  // The rows are split in bands loaded from different threads: each row
+  // has its own words in the grid, and is its own stream of colors so that
+  // the board does not depend on the number of threads.
+  const auto band = (m_height + threads - 1) / threads;
+
+  std::vector<std::thread> workers;
+  for (auto first = 0; first < m_height; first += band)
   {
-    return true;
+    workers.emplace_back(&Board::generateRows, this, first, std::min(m_height, first + band));
   }
-  if (validCell(x - 1, y) && m_cells[left].owner == owner)
+
+  for (auto &worker : workers)
   {
-    return true;
+    worker.join();
   }
-  if (validCell(x + 1, y) && m_cells[right].owner == owner)
+}
+
+void Board::generateRows(int first, int last)
+{
+  std::vector<std::uint8_t> bytes(m_width);
+
+  for (auto y = first; y < last; ++y)
   {
-    return true;
+    generateColors(m_seed, static_cast<std::uint64_t>(y), m_width, bytes.data());
+    for (auto &byte : bytes)
+    {
+      byte = PackedCells::pack(Cell{Owner::Nobody, static_cast<Color>(byte)});
+    }
+
+    m_grid.loadRow(y, bytes.data());
   }
+}
 
-  return false;
+void Board::generateSpan(int y, int first, int last, std::uint8_t *bytes) const noexcept
+{
+  // Each row of a chunk is its own stream of colors, so that the color of
+  // a cell only depends on the seed and on its coordinates.
+  for (auto x = first; x < last; x += CHUNK_DIMS)
+  {
+    const auto chunk  = static_cast<std::uint32_t>(x / CHUNK_DIMS);
+    const auto stream = static_cast<std::uint64_t>(y) << 32 | chunk;
+    generateColors(m_seed, stream, std::min(CHUNK_DIMS, last - x), bytes + x);
+  }
+
+  for (auto x = first; x < last; ++x)
+  {
+    bytes[x] = PackedCells::pack(Cell{Owner::Nobody, static_cast<Color>(bytes[x])});
+  }
 }
 
-auto Board::countFor(const Owner &owner) const noexcept -> int
+void Board::expand()
 {
-  return static_cast<int>(std::count_if(m_cells.begin(), m_cells.end(), [&owner](const Cell &c) {
-    return c.owner == owner;
-  }));
+  while (m_regions.exposed())
+  {
+    grow();
+  }
 }
 
-void Board::updateStatus() noexcept
+void Board::grow()
 {
-  std::unordered_map<Owner, int> cellsToGain;
+  // The cells go back to the state they had before the first move, which
+  // is then played again on the larger board.
+  const auto moves = m_moves;
+  for (const auto &index : m_cells)
+  {
+    m_grid.setOwner(index, Owner::Nobody);
+  }
 
-  const auto validCell = [this](const int x, const int y) {
-    return x >= 0 && y >= 0 && x < m_width && y < m_height;
-  };
+  const auto width  = std::min(m_fullWidth, m_width + CHUNK_DIMS);
+  const auto height = std::min(m_fullHeight, m_height + CHUNK_DIMS);
 
-  bool someCellsToGain = false;
-  auto y               = 0;
-  while (y < m_height && !someCellsToGain)
+  PackedCells grid(width, height);
+  std::vector<std::uint8_t> row(width);
+  for (auto y = 0; y < height; ++y)
   {
-    auto x = 0;
-
-    while (x < m_width && !someCellsToGain)
+    auto first = 0;
+    if (y < m_height)
     {
-      const auto &c = m_cells[linear(x, y)];
-      if (c.owner == Owner::Nobody)
-      {
-        if (validCell(x + 1, y))
-        {
-          const auto &right = m_cells[linear(x + 1, y)];
-          someCellsToGain |= (right.owner != Owner::Nobody);
-        }
-        if (validCell(x - 1, y))
-        {
-          const auto &left = m_cells[linear(x - 1, y)];
-          someCellsToGain |= (left.owner != Owner::Nobody);
-        }
-        if (validCell(x, y + 1))
-        {
-          const auto &top = m_cells[linear(x, y + 1)];
-          someCellsToGain |= (top.owner != Owner::Nobody);
-        }
-        if (validCell(x, y - 1))
-        {
-          const auto &bottom = m_cells[linear(x, y - 1)];
-          someCellsToGain |= (bottom.owner != Owner::Nobody);
-        }
-      }
-
-      ++x;
+      m_grid.storeRow(y, row.data());
+      first = m_width;
     }
 
-    ++y;
+    generateSpan(y, first, width, row.data());
+    grid.loadRow(y, row.data());
   }
 
-  auto player = countFor(Owner::Player);
-  auto ai     = countFor(Owner::AI);
+  m_grid   = std::move(grid);
+  m_width  = width;
+  m_height = height;
+
+  const auto tree = m_tree.has_value();
+  m_tree.reset();
 
-  if (!someCellsToGain)
+  buildRegions();
+  for (const auto &move : moves)
   {
-    info("player: " + std::to_string(player) + " - ai: " + std::to_string(ai));
+    apply(move.owner, move.color);
   }
 
-  if (someCellsToGain)
+  useQuadTree(tree);
+
+  debug("Generated board up to " + std::to_string(m_width) + "x" + std::to_string(m_height));
+}
+
+auto Board::apply(const Owner &owner, const Color &color) noexcept -> int
+{
+  // The moves are applied on the regions: only the cells of the regions
+  // which were absorbed need to be updated.
+  m_absorbed.clear();
+  m_regions.absorb(owner, color, m_absorbed);
+  m_moves.push_back(Move{owner, color, static_cast<int>(m_cells.size())});
+
+  auto gained = 0;
+  for (const auto &id : m_absorbed)
   {
-    m_status = Status::Running;
+    const auto &region = m_regions.region(id);
+
+    paint(region, owner);
+    gained += region.size;
   }
-  else if (player == ai)
+
+  updateQuadTree(m_moves.back().start);
+
+  return gained;
+}
+
+void Board::resize()
+{
+  m_grid = PackedCells(m_width, m_height);
+}
+
+void Board::assign(int x, int y, const Cell &cell) noexcept
+{
+  m_grid.set(x, y, cell);
+}
+
+void Board::buildRegions()
+{
+  // The grid still holds the color of the owned cells at this point.
+  m_regions = RegionGraph(
+    m_width,
+    m_height,
+    [this](const int x, const int y) { return Cell{ownerAt(x, y), colorAt(x, y)}; },
+    m_fullWidth,
+    m_fullHeight);
+
+  m_cells.clear();
+  m_moves.clear();
+}
+
+void Board::buildQuadTree()
+{
+  if (m_tree)
   {
-    m_status = Status::Draw;
+    m_tree = QuadTree(m_width, m_height, [this](const int x, const int y) {
+      return blockOf(Cell{ownerAt(x, y), colorAt(x, y)});
+    });
   }
-  else if (player > ai)
+}
+
+void Board::updateQuadTree(int start)
+{
+  if (!m_tree)
   {
-    m_status = Status::Win;
+    return;
   }
-  else
+
+  for (auto id = start; id < static_cast<int>(m_cells.size()); ++id)
   {
-    m_status = Status::Lost;
+    const auto [x, y] = m_grid.position(m_cells[id]);
+    m_tree->set(x, y, blockOf(Cell{ownerAt(x, y), colorAt(x, y)}));
   }
+
+  m_tree->compact();
+}
+
+void Board::paint(const RegionGraph::Region &region, const Owner &owner)
+{
+  // The cells of a free region are the free cells with its color which can
+  // be reached from its seed.
+  m_grid.fill(m_grid.index(region.seed % m_width, region.seed / m_width),
+              Cell{Owner::Nobody, region.color},
+              owner,
+              m_cells,
+              m_pending);
 }
 
-Color generateRandomColor() noexcept
+auto Board::ownerAt(int x, int y) const noexcept -> Owner
 {
-  const auto max   = static_cast<int>(Color::Count);
-  const auto index = std::rand() % max;
+  return m_grid.owner(x, y);
+}
 
-  return static_cast<Color>(index);
+auto Board::colorAt(int x, int y) const noexcept -> Color
+{
+  return m_grid.color(x, y);
 }
 
-auto olcColorFromCellColor(const Color &c) -> olc::Pixel
+auto Board::countFor(const Owner &owner) const noexcept -> int
 {
-  switch (c)
+  return m_regions.count(owner);
+}
+
+void Board::updateStatus() noexcept
+{
+  // The game is over as soon as its outcome is decided: the remaining free
+  // cells can only be gained by one of the owners.
+  std::array<int, static_cast<int>(Owner::Count)> finals{};
+  if (!m_regions.decided(finals))
   {
-    case Color::Red:
-      return olc::RED;
-    case Color::Green:
-      return olc::GREEN;
-    case Color::Blue:
-      return olc::BLUE;
-    case Color::Yellow:
-      return olc::YELLOW;
-    case Color::Cyan:
-      return olc::CYAN;
-    case Color::Magenta:
-      return olc::MAGENTA;
-    case Color::Black:
-      return olc::BLACK;
-    case Color::White:
-      return olc::WHITE;
-    default:
-      return olc::GREY;
+    m_status = Status::Running;
+    return;
+  }
+
+  const auto player = finals[static_cast<int>(Owner::Player)];
+  const auto ai     = finals[static_cast<int>(Owner::AI)];
+
+  info("player: " + std::to_string(player) + " - ai: " + std::to_string(ai));
+
+  if (player == ai)
+  {
+    m_status = Status::Draw;
+  }
+  else if (player > ai)
+  {
+    m_status = Status::Win;
+  }
+  else
+  {
+    m_status = Status::Lost;
   }
 }
 
@@ -1,41 +1,18 @@
 
 #pragma once
 
+#include "Cell.hh"
+#include "PackedCells.hh"
+#include "QuadTree.hh"
+#include "RegionGraph.hh"
+#include <array>
 #include <core_utils/CoreObject.hh>
+#include <iosfwd>
 #include <memory>
-#include <olcEngine.hh>
+#include <optional>
 
 namespace pge {
 
-/// @brief - Who owns a tile.
-enum class Owner
-{
-  Nobody,
-  AI,
-  Player
-};
-
-/// @brief - The available colors for a cell.
-enum class Color
-{
-  Red,
-  Green,
-  Blue,
-  Yellow,
-  Cyan,
-  Magenta,
-  Black,
-  White,
-  Count
-};
-
-/// @brief - A cell and its properties.
-struct Cell
-{
-  Owner owner{Owner::Nobody};
-  Color color{Color::Black};
-};
-
 /// @brief - The state of the board.
 enum class Status
 {
@@ -45,16 +22,80 @@ enum class Status
   Lost
 };
 
+/// @brief - How the cells of a board are generated: all of them when the
+/// board is created, or by chunks as the territories reach them.
+enum class Generation
+{
+  Eager,
+  Chunked
+};
+
 /// @brief - The board, regrouping a certain amount of cells.
+/// A chunked board only generates the top left part of the board, made of
+/// whole chunks, and grows it as the territories reach its edges: the time
+/// to create it and the memory it uses are proportional to the explored
+/// area rather than to the size of the board. The cells which are not
+/// generated yet form the outside region of the graph of the board. Once a
+/// move lets a territory or the regions it can absorb touch the outside,
+/// the generated part grows by a chunk in each direction and the moves are
+/// played again on the larger graph: as the absorbed regions never touched
+/// the outside, they are the same on the larger board.
 class Board : public utils::CoreObject
 {
   public:
-  Board(int width, int height);
-
+  /// @brief - The seed of the boards generated without an explicit one.
+  static constexpr std::uint64_t DEFAULT_SEED = 0u;
+
+  /// @brief - The width and height in cells of the chunks of a chunked board.
+  static constexpr auto CHUNK_DIMS = 64;
+
+  /// @brief - The largest number of cells of a chunked board: the counts of
+  /// cells and the scores of the engines are stored on 32-bit integers.
+  static constexpr auto MAX_CHUNKED_CELLS = 1 << 28;
+
+  /// @brief - Create a board whose colors are generated from a seed: the
+  /// same seed always gives the same board. Large boards are generated
+  /// from several threads. The player starts in the top left corner and
+  /// the AI in the opposite corner of the board, or of the first chunk for
+  /// a chunked board.
+  /// @param width - the width of the board.
+  /// @param height - the height of the board.
+  /// @param seed - the seed used to pick the colors of the cells.
+  /// @param generation - whether the cells are all generated right away or
+  /// by chunks as they are reached. The color of a cell of a chunked board
+  /// only depends on the seed and on the coordinates of the cell.
+  Board(int width,
+        int height,
+        std::uint64_t seed           = DEFAULT_SEED,
+        const Generation &generation = Generation::Eager);
+
+  /// @brief - The width of the generated part of the board, which is the
+  /// whole board unless it is chunked.
+  /// @return - the width in cells.
   int width() const noexcept;
 
+  /// @brief - The height of the generated part of the board, which is the
+  /// whole board unless it is chunked.
+  /// @return - the height in cells.
   int height() const noexcept;
 
+  /// @brief - The width of the whole board, including the cells which are
+  /// not generated yet.
+  /// @return - the width in cells.
+  int fullWidth() const noexcept;
+
+  /// @brief - The height of the whole board, including the cells which are
+  /// not generated yet.
+  /// @return - the height in cells.
+  int fullHeight() const noexcept;
+
+  auto generation() const noexcept -> Generation;
+
+  /// @brief - The seed of the colors of the board. Boards loaded from files
+  /// saved before the seed was stored keep the seed they had.
+  /// @return - the seed of the board.
+  auto seed() const noexcept -> std::uint64_t;
+
   Cell at(int x, int y) const;
 
   auto colorOf(const Owner &owner) const noexcept -> Color;
@@ -63,34 +104,152 @@ class Board : public utils::CoreObject
 
   float occupiedBy(const Owner &owner) const noexcept;
 
+  /// @brief - Applies a move: the territory of the owner takes the color
+  /// and absorbs the free cells of this color touching it. The cells which
+  /// changed are recorded so that the move can be undone.
+  /// @param owner - the owner picking the color.
+  /// @param color - the color picked.
   void changeColorOf(const Owner &owner, const Color &color) noexcept;
 
+  /// @brief - Plays the remaining moves of a game whose outcome is decided,
+  /// so that the board shows the final territories. The moves are recorded
+  /// like any other move. A chunked board does not grow for these moves:
+  /// the territories stop at the edges of the generated part, whose cells
+  /// beyond are already counted in the outcome.
+  /// @param next - the owner playing the first of the remaining moves, so
+  /// that the owners keep alternating in the recorded moves.
+  void complete(const Owner &next) noexcept;
+
+  /// @brief - The number of moves which can be undone.
+  /// @return - the number of moves applied since the board was generated or
+  /// loaded.
+  int history() const noexcept;
+
+  /// @brief - Reverts the last move, at a cost proportional to the number of
+  /// cells it changed.
+  /// @return - the owner whose move was reverted, or `Nobody` if there was no
+  /// move to undo.
+  auto undo() noexcept -> Owner;
+
+  /// @brief - The color picked by an owner playing greedily, as defined by
+  /// `RegionGraph::bestColor`. This is also the move of the greedy engine.
+  /// @param owner - the owner picking the color.
+  /// @return - the color to pick.
   auto bestColorFor(const Owner &owner) const noexcept -> Color;
 
+  /// @brief - The state of the game. The game is over as soon as its outcome
+  /// is decided, even if some cells can still be gained.
+  /// @return - the state of the game.
   auto status() const noexcept -> Status;
 
+  /// @brief - The regions of the board, which hold the state of the game
+  /// in a form suited to explore moves.
+  /// @return - the graph of the regions of the board.
+  auto regions() const noexcept -> const RegionGraph &;
+
+  /// @brief - The Zobrist hash of the board, updated as the owners change
+  /// their color.
+  /// @return - the hash of the board.
+  auto hash() const noexcept -> std::uint64_t;
+
+  /// @brief - Maintains a quadtree of the cells as the moves are applied:
+  /// the territories then collapse into a few blocks, which can be drawn
+  /// and saved at a cost proportional to their boundaries. Updating the
+  /// tree slows down the moves, so it is not maintained by default.
+  /// @param enable - whether the tree should be maintained.
+  void useQuadTree(bool enable);
+
+  /// @brief - The quadtree of the cells, whose values are described by
+  /// `cellOf`.
+  /// @return - the tree, or `nullptr` if it is not maintained.
+  auto quadTree() const noexcept -> const QuadTree *;
+
+  /// @brief - The cell described by a value of the quadtree: the owned
+  /// cells only keep their owner, as their color is the one of the owner.
+  /// @param value - a value of the quadtree.
+  /// @return - the corresponding cell.
+  auto cellOf(QuadTree::Value value) const noexcept -> Cell;
+
+  /// @brief - Saves the board: when the quadtree is maintained, the nodes
+  /// of the tree are saved instead of the cells. The seed is saved after
+  /// the dimensions so that the board keeps playing the same way. Only the
+  /// generated part of a chunked board is saved, after the dimensions of
+  /// the whole board.
+  /// @param file - the file to save to.
   void save(const std::string &file) const noexcept;
   void load(const std::string &file);
 
   private:
+  /// @brief - A move applied to the board.
+  struct Move
+  {
+    Owner owner;
+    Color color;
+
+    // The offset of the first cell absorbed by the move in `m_cells`.
+    int start;
+  };
+
   int m_width;
   int m_height;
 
-  std::vector<Cell> m_cells{};
+  /// @brief - The dimensions of the whole board, equal to the ones of the
+  /// generated part unless the board is chunked.
+  int m_fullWidth;
+  int m_fullHeight;
+
+  Generation m_generation;
+
+  /// @brief - The seed of the colors of the board.
+  std::uint64_t m_seed;
+
+  /// @brief - The owner and the color of each cell, packed on 5 bits. The
+  /// color of an owned cell is the color of its owner, so the stored color
+  /// of a cell never changes once it is owned.
+  PackedCells m_grid{};
+
+  /// @brief - The regions of the board, used to apply the moves.
+  RegionGraph m_regions{};
+
+  /// @brief - Buffers reused from one move to the next to avoid allocating
+  /// while applying a move.
+  std::vector<int> m_absorbed{};
+  std::vector<PackedCells::Seed> m_pending{};
+
+  /// @brief - The indices in the grid of the cells absorbed by the moves, in the
+  /// order of the moves. The cells of each move start at the offset stored
+  /// in `m_moves`.
+  std::vector<int> m_cells{};
+  std::vector<Move> m_moves{};
 
   Status m_status{Status::Running};
 
+  /// @brief - The quadtree of the cells, when it is maintained.
+  std::optional<QuadTree> m_tree{};
+
   void initialize();
-  int linear(int x, int y) const noexcept;
-  bool hasBorderWith(int x, int y, const Owner &owner) const noexcept;
+  void generate();
+  void generateRows(int first, int last);
+  void generateSpan(int y, int first, int last, std::uint8_t *bytes) const noexcept;
+  void expand();
+  void grow();
+  auto apply(const Owner &owner, const Color &color) noexcept -> int;
+  void resize();
+  void assign(int x, int y, const Cell &cell) noexcept;
+  void buildRegions();
+  void buildQuadTree();
+  void updateQuadTree(int start);
+  void loadRows(std::istream &in, const std::string &file, bool legacy);
+  void loadQuadTree(std::istream &in, const std::string &file);
+  void paint(const RegionGraph::Region &region, const Owner &owner);
+  auto ownerAt(int x, int y) const noexcept -> Owner;
+  auto colorAt(int x, int y) const noexcept -> Color;
   auto countFor(const Owner &owner) const noexcept -> int;
   void updateStatus() noexcept;
 };
 
 using BoardShPtr = std::shared_ptr<Board>;
 
-Color generateRandomColor() noexcept;
-auto olcColorFromCellColor(const Color &c) -> olc::Pixel;
 auto colorName(const Color &c) -> std::string;
 auto ownerName(const Owner &o) -> std::string;
 } // namespace pge
@@ -0,0 +1,45 @@
+
+#pragma once
+
+namespace pge {
+
+/// @brief - Who owns a tile.
+enum class Owner
+{
+  Nobody,
+  AI,
+  Player,
+  Count
+};
+
+/// @brief - The available colors for a cell.
+enum class Color
+{
+  Red,
+  Green,
+  Blue,
+  Yellow,
+  Cyan,
+  Magenta,
+  Black,
+  White,
+  Count
+};
+
+/// @brief - The opponent of an owner in a game between the player and the
+/// AI.
+/// @param owner - either `Owner::Player` or `Owner::AI`.
+/// @return - the other owner.
+inline auto opponentOf(const Owner &owner) noexcept -> Owner
+{
+  return (owner == Owner::AI ? Owner::Player : Owner::AI);
+}
+
+/// @brief - A cell and its properties.
+struct Cell
+{
+  Owner owner{Owner::Nobody};
+  Color color{Color::Black};
+};
+
+} // namespace pge
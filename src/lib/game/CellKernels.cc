@@ -0,0 +1,172 @@
+
+#include "CellKernels.hh"
+#include <atomic>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#  include <immintrin.h>
+#  define PGE_X86_KERNELS
+#endif
+
+namespace pge::kernels {
+namespace {
+
+using Slices = std::array<std::uint64_t, BYTE_BITS>;
+
+/// @brief - A set of implementations of the kernels.
+struct Kernels
+{
+  void (*slice)(const std::uint8_t *, int, Slices &) noexcept;
+  void (*unslice)(const std::uint64_t *, int, int, std::uint8_t *) noexcept;
+  const char *name;
+};
+
+void sliceScalar(const std::uint8_t *bytes, int count, Slices &slices) noexcept
+{
+  slices.fill(0u);
+
+  for (auto id = 0; id < count; ++id)
+  {
+    for (auto b = 0; b < BYTE_BITS; ++b)
+    {
+      slices[b] |= static_cast<std::uint64_t>((bytes[id] >> b) & 1u) << id;
+    }
+  }
+}
+
+void unsliceScalar(const std::uint64_t *slices, int bits, int count, std::uint8_t *bytes) noexcept
+{
+  for (auto id = 0; id < count; ++id)
+  {
+    auto value = 0u;
+    for (auto b = 0; b < bits; ++b)
+    {
+      value |= static_cast<unsigned>((slices[b] >> id) & 1u) << b;
+    }
+
+    bytes[id] = static_cast<std::uint8_t>(value);
+  }
+}
+
+constexpr Kernels SCALAR_KERNELS{sliceScalar, unsliceScalar, "scalar"};
+
+#ifdef PGE_X86_KERNELS
+
+__attribute__((target("avx2"))) void sliceAvx2(const std::uint8_t *bytes,
+                                               int count,
+                                               Slices &slices) noexcept
+{
+  // Incomplete chunks are copied to a buffer padded with zeros, so that the
+  // loads stay in bounds and the extra bits are cleared.
+  alignas(32) std::uint8_t buf[KERNEL_WIDTH] = {};
+  auto src = bytes;
+  if (count < KERNEL_WIDTH)
+  {
+    std::memcpy(buf, bytes, count);
+    src = buf;
+  }
+
+  const auto lo = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src));
+  const auto hi = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + 32));
+
+  for (auto b = 0; b < BYTE_BITS; ++b)
+  {
+    // Moves the bit `b` of each byte to its most significant bit: the bits
+    // crossing from one byte to the next one land below it.
+    const auto shift = _mm_cvtsi32_si128(BYTE_BITS - 1 - b);
+    const auto l = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_sll_epi16(lo, shift)));
+    const auto h = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_sll_epi16(hi, shift)));
+
+    slices[b] = static_cast<std::uint64_t>(l) | (static_cast<std::uint64_t>(h) << 32);
+  }
+}
+
+__attribute__((target("avx2"))) void unsliceAvx2(const std::uint64_t *slices,
+                                                 int bits,
+                                                 int count,
+                                                 std::uint8_t *bytes) noexcept
+{
+  // Each byte of the output receives the byte of the slice holding its bit,
+  // which is then tested against the position of the bit in this byte.
+  // clang-format off
+  const auto spread = _mm256_setr_epi8(0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1,
+                                       2, 2, 2, 2, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 3, 3);
+  // clang-format on
+  const auto select = _mm256_set1_epi64x(0x8040201008040201);
+
+  alignas(32) std::uint8_t buf[KERNEL_WIDTH];
+  for (auto half = 0; half < 2; ++half)
+  {
+    auto out = _mm256_setzero_si256();
+    for (auto b = 0; b < bits; ++b)
+    {
+      const auto mask = static_cast<int>(slices[b] >> (32 * half));
+
+      auto v = _mm256_shuffle_epi8(_mm256_set1_epi32(mask), spread);
+      v      = _mm256_cmpeq_epi8(_mm256_and_si256(v, select), select);
+      out    = _mm256_or_si256(out,
+                            _mm256_and_si256(v, _mm256_set1_epi8(static_cast<char>(1u << b))));
+    }
+
+    _mm256_store_si256(reinterpret_cast<__m256i *>(buf + 32 * half), out);
+  }
+
+  std::memcpy(bytes, buf, count);
+}
+
+constexpr Kernels AVX2_KERNELS{sliceAvx2, unsliceAvx2, "avx2"};
+
+#endif
+
+auto detect() noexcept -> const Kernels *
+{
+#ifdef PGE_X86_KERNELS
+  if (__builtin_cpu_supports("avx2"))
+  {
+    return &AVX2_KERNELS;
+  }
+#endif
+
+  return &SCALAR_KERNELS;
+}
+
+/// @brief - The kernels used by the program, chosen once when it starts.
+std::atomic<const Kernels *> g_kernels{detect()};
+
+} // namespace
+
+void slice(const std::uint8_t *bytes, int count, Slices &slices) noexcept
+{
+  g_kernels.load(std::memory_order_relaxed)->slice(bytes, count, slices);
+}
+
+void unslice(const std::uint64_t *slices, int bits, int count, std::uint8_t *bytes) noexcept
+{
+  g_kernels.load(std::memory_order_relaxed)->unslice(slices, bits, count, bytes);
+}
+
+auto implementation() -> std::string
+{
+  return g_kernels.load(std::memory_order_relaxed)->name;
+}
+
+bool useImplementation(const std::string &name) noexcept
+{
+  if (name == SCALAR_KERNELS.name)
+  {
+    g_kernels = &SCALAR_KERNELS;
+    return true;
+  }
+
+#ifdef PGE_X86_KERNELS
+  if (name == AVX2_KERNELS.name && __builtin_cpu_supports("avx2"))
+  {
+    g_kernels = &AVX2_KERNELS;
+    return true;
+  }
+#endif
+
+  return false;
+}
+
+} // namespace pge::kernels
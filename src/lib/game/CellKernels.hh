@@ -0,0 +1,47 @@
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+
+namespace pge::kernels {
+
+/// @brief - The number of bits of a byte, each of them producing a slice.
+constexpr auto BYTE_BITS = 8;
+
+/// @brief - The largest number of bytes processed by a single call to the
+/// kernels: one bit of each byte fits in a 64-bit word.
+constexpr auto KERNEL_WIDTH = 64;
+
+/// @brief - Splits bytes into bit slices: the slice `b` receives the bit `b`
+/// of each byte, the first byte going to the least significant bit. The
+/// bits past the number of bytes are cleared.
+/// The implementation is picked when the program starts from the features
+/// of the processor, with a scalar version as fallback.
+/// @param bytes - the bytes to split.
+/// @param count - the number of bytes, at most `KERNEL_WIDTH`.
+/// @param slices - output slices.
+void slice(const std::uint8_t *bytes,
+           int count,
+           std::array<std::uint64_t, BYTE_BITS> &slices) noexcept;
+
+/// @brief - The reverse of `slice`: builds bytes from the first bit slices,
+/// the bits of the bytes without a slice being cleared.
+/// @param slices - the slices to read.
+/// @param bits - the number of slices to read, at most `BYTE_BITS`.
+/// @param count - the number of bytes to build, at most `KERNEL_WIDTH`.
+/// @param bytes - output bytes.
+void unslice(const std::uint64_t *slices, int bits, int count, std::uint8_t *bytes) noexcept;
+
+/// @brief - The name of the implementation used by the kernels, such as
+/// `avx2` or `scalar`.
+auto implementation() -> std::string;
+
+/// @brief - Forces the implementation used by the kernels, mostly to compare
+/// them against each other.
+/// @param name - the name of the implementation to use.
+/// @return - `false` if this implementation is not available.
+bool useImplementation(const std::string &name) noexcept;
+
+} // namespace pge::kernels
@@ -2,14 +2,28 @@
 #include "Game.hh"
 #include "Menu.hh"
 #include <cxxabi.h>
+#include <random>
 
 namespace pge {
 constexpr auto DEFAULT_BOARD_DIMS  = 32;
 constexpr auto DEFAULT_MENU_HEIGHT = 50;
+constexpr auto DEFAULT_AI_KIND     = ai::Kind::Greedy;
+
+/// @brief - Whether the board plays the remaining moves by itself once the
+/// outcome of the game is decided.
+constexpr auto AUTO_COMPLETE_DECIDED_GAMES = true;
 
 constexpr auto DEFAULT_GAME_FINISHED_ALERT_DURATION_IN_MS = 3000;
 
 namespace {
+/// @brief - Generates a new board, each game starting from a different seed.
+auto generateBoard() -> BoardShPtr
+{
+  const auto seed = (static_cast<std::uint64_t>(std::random_device()()) << 32)
+                    | std::random_device()();
+  return std::make_shared<Board>(DEFAULT_BOARD_DIMS, DEFAULT_BOARD_DIMS, seed);
+}
+
 auto generateMenu(const olc::vi2d &pos,
                   const olc::vi2d &size,
                   const std::string &text,
@@ -99,14 +113,22 @@ Game::Game()
       false, // terminated
       Color::White,
       Color::Black,
+      false, // thinking
     })
   , m_menus()
-  , m_board(std::make_shared<Board>(DEFAULT_BOARD_DIMS, DEFAULT_BOARD_DIMS))
+  , m_board(generateBoard())
+  , m_aiKind(DEFAULT_AI_KIND)
+  , m_ai(ai::newEngine(m_aiKind))
+  , m_ponderer(std::make_shared<ai::Ponderer>(m_ai))
+  , m_aiMove()
 {
   setService("game");
+  m_board->useQuadTree(true);
 
   m_state.playerColor = m_board->colorOf(Owner::Player);
   m_state.aiColor     = m_board->colorOf(Owner::AI);
+
+  ponder();
 }
 
 Game::~Game() {}
@@ -148,6 +170,8 @@ void Game::performAction(float /*x*/, float /*y*/)
 
 bool Game::step(float /*tDelta*/)
 {
+  updateAITurn();
+
   // When the game is paused it is not over yet.
   if (m_state.paused)
   {
@@ -188,29 +212,78 @@ const Board &Game::board() const noexcept
 
 void Game::setPlayerColor(const Color &color)
 {
+  if (m_state.thinking)
+  {
+    warn("ignoring change to color " + colorName(color), "ai is still thinking");
+    return;
+  }
   if (m_state.playerColor == color)
   {
     warn("ignoring change to color " + colorName(color), "player already has this color");
     return;
   }
 
-  m_menus.colors[m_state.playerColor]->setEnabled(true);
-  m_menus.colors[m_state.aiColor]->setEnabled(true);
-
   m_board->changeColorOf(Owner::Player, color);
-  const auto aiColor = m_board->bestColorFor(Owner::AI);
-  m_board->changeColorOf(Owner::AI, aiColor);
+  m_state.playerColor = color;
+  info("player now has color " + colorName(color));
 
-  m_menus.colors[color]->setEnabled(false);
-  if (m_board->isPlayerAndAiInContact())
+  if (m_board->status() != Status::Running)
   {
-    m_menus.colors[m_board->colorOf(Owner::AI)]->setEnabled(false);
+    completeBoard(Owner::AI);
+    return;
   }
 
-  m_state.playerColor = color;
-  m_state.aiColor     = aiColor;
-  info("player now has color " + colorName(color));
-  info("ai choses " + colorName(aiColor));
+  // The reply may already be known if the AI pondered this move.
+  m_ponderer->stop();
+
+  Color aiColor;
+  if (m_ponderer->reply(m_board->hash(), aiColor))
+  {
+    applyAIMove(aiColor);
+    return;
+  }
+
+  startAITurn();
+}
+
+void Game::setAI(const ai::Kind &kind)
+{
+  cancelAITurn();
+
+  m_aiKind   = kind;
+  m_ai       = ai::newEngine(kind);
+  m_ponderer = std::make_shared<ai::Ponderer>(m_ai);
+  info("ai now uses " + ai::kindName(kind) + " engine");
+
+  ponder();
+}
+
+void Game::cycleAI()
+{
+  const auto next = (static_cast<int>(m_aiKind) + 1) % static_cast<int>(ai::Kind::Count);
+  setAI(static_cast<ai::Kind>(next));
+}
+
+void Game::undo()
+{
+  cancelAITurn();
+
+  if (m_board->history() == 0)
+  {
+    info("No move to undo");
+    return;
+  }
+
+  // A turn is made of a move of the player followed by a move of the AI.
+  if (m_board->undo() == Owner::AI)
+  {
+    m_board->undo();
+  }
+
+  updateUIAfterBoardChange();
+  info("Reverted last turn, " + std::to_string(m_board->history()) + " move(s) left");
+
+  ponder();
 }
 
 void Game::save(const std::string &file) const noexcept
@@ -220,15 +293,20 @@ void Game::save(const std::string &file) const noexcept
 
 void Game::load(const std::string &file)
 {
+  cancelAITurn();
   m_board->load(file);
   updateUIAfterBoardChange();
+  ponder();
 }
 
 void Game::reset()
 {
   debug("Reset board");
-  m_board = std::make_shared<Board>(DEFAULT_BOARD_DIMS, DEFAULT_BOARD_DIMS);
+  cancelAITurn();
+  m_board = generateBoard();
+  m_board->useQuadTree(true);
   updateUIAfterBoardChange();
+  ponder();
 }
 
 void Game::enable(bool enable)
@@ -257,7 +335,19 @@ void Game::updateUI()
   auto str = writeTerritory(m_board->occupiedBy(Owner::Player), "player");
   m_menus.playerTerritory->setText(str);
 
-  str = writeTerritory(m_board->occupiedBy(Owner::AI), "ai");
+  // Engines leaving some moves to another one say so, as they play as this
+  // other engine.
+  auto engine = ai::kindName(m_aiKind);
+  if (m_ai->delegated())
+  {
+    engine += ", fallback";
+  }
+
+  str = writeTerritory(m_board->occupiedBy(Owner::AI), "ai (" + engine + ")");
+  if (m_state.thinking)
+  {
+    str += " (thinking)";
+  }
   m_menus.aiTerritory->setText(str);
 
   m_menus.win.update(m_board->status() == Status::Win);
@@ -380,6 +470,82 @@ void Game::updateUIAfterBoardChange() noexcept
   }
 }
 
+void Game::startAITurn()
+{
+  m_state.thinking = true;
+  for (auto &[color, menu] : m_menus.colors)
+  {
+    menu->setEnabled(false);
+  }
+
+  // The board is not modified while the AI is thinking: the search can read
+  // it while it is rendered.
+  m_aiMove = std::async(std::launch::async, [engine = m_ai, board = m_board]() {
+    return engine->pick(*board, Owner::AI);
+  });
+}
+
+void Game::updateAITurn()
+{
+  if (!m_state.thinking
+      || m_aiMove.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+  {
+    return;
+  }
+
+  m_state.thinking = false;
+  applyAIMove(m_aiMove.get());
+}
+
+void Game::applyAIMove(const Color &color)
+{
+  m_board->changeColorOf(Owner::AI, color);
+  info("ai choses " + colorName(color));
+
+  if (m_board->status() != Status::Running)
+  {
+    completeBoard(Owner::Player);
+    return;
+  }
+
+  updateUIAfterBoardChange();
+  ponder();
+}
+
+void Game::completeBoard(const Owner &next)
+{
+  m_ponderer->stop();
+
+  if (AUTO_COMPLETE_DECIDED_GAMES)
+  {
+    m_board->complete(next);
+  }
+
+  updateUIAfterBoardChange();
+}
+
+void Game::ponder()
+{
+  m_ponderer->start(m_board->regions(), Owner::AI);
+}
+
+void Game::cancelAITurn()
+{
+  if (!m_state.thinking)
+  {
+    return;
+  }
+
+  m_state.thinking = false;
+  m_ai->abort();
+  m_aiMove.wait();
+  m_aiMove = std::future<Color>();
+  m_ai->resume();
+
+  updateUIAfterBoardChange();
+  info("Dropped the move of the ai");
+}
+
 bool Game::TimedMenu::update(bool active) noexcept
 {
   // In case the menu should be active.
@@ -422,4 +588,29 @@ bool Game::TimedMenu::update(bool active) noexcept
   return menu->visible();
 }
 
+auto olcColorFromCellColor(const Color &c) -> olc::Pixel
+{
+  switch (c)
+  {
+    case Color::Red:
+      return olc::RED;
+    case Color::Green:
+      return olc::GREEN;
+    case Color::Blue:
+      return olc::BLUE;
+    case Color::Yellow:
+      return olc::YELLOW;
+    case Color::Cyan:
+      return olc::CYAN;
+    case Color::Magenta:
+      return olc::MAGENTA;
+    case Color::Black:
+      return olc::BLACK;
+    case Color::White:
+      return olc::WHITE;
+    default:
+      return olc::GREY;
+  }
+}
+
 } // namespace pge
@@ -3,10 +3,14 @@
 
 #include <core_utils/CoreObject.hh>
 #include <core_utils/TimeUtils.hh>
+#include <future>
 #include <memory>
+#include <olcEngine.hh>
 #include <vector>
 
 #include "Board.hh"
+#include "Engine.hh"
+#include "Ponderer.hh"
 
 namespace pge {
 
@@ -70,6 +74,20 @@ class Game : public utils::CoreObject
 
   const Board &board() const noexcept;
   void setPlayerColor(const Color &color);
+
+  /// @brief - Changes the engine used to pick the colors of the AI. It is
+  /// used starting from the next move.
+  /// @param kind - the kind of engine to use.
+  void setAI(const ai::Kind &kind);
+
+  /// @brief - Switches the AI to the next kind of engine, going back to the
+  /// first one after the last one.
+  void cycleAI();
+
+  /// @brief - Reverts the last turn: the last move of the AI and the move of
+  /// the player before it. Nothing happens if no move was played.
+  void undo();
+
   void save(const std::string &file) const noexcept;
   void load(const std::string &file);
   void reset();
@@ -89,6 +107,31 @@ class Game : public utils::CoreObject
   auto generateGameOver(int width, int height) -> std::vector<MenuShPtr>;
   void updateUIAfterBoardChange() noexcept;
 
+  /// @brief - Starts the search of the move of the AI in the background. The
+  /// color buttons are disabled until the move is applied.
+  void startAITurn();
+
+  /// @brief - Applies the move of the AI if its search is over.
+  void updateAITurn();
+
+  /// @brief - Applies the move picked by the AI and starts pondering its
+  /// next one.
+  /// @param color - the color picked by the AI.
+  void applyAIMove(const Color &color);
+
+  /// @brief - Called once the outcome of the game is decided, to optionally
+  /// play the remaining moves.
+  /// @param next - the owner whose turn it is.
+  void completeBoard(const Owner &next);
+
+  /// @brief - Starts searching the replies of the AI to the moves the player
+  /// can play on the current board.
+  void ponder();
+
+  /// @brief - Waits for the search of the AI to be over and drops its move.
+  /// This is used before changing the board from another place.
+  void cancelAITurn();
+
   private:
   /// @brief - Convenience structure allowing to group information
   /// about a timed menu.
@@ -138,6 +181,10 @@ class Game : public utils::CoreObject
 
     Color playerColor;
     Color aiColor;
+
+    // Whether the AI is searching for its move. The board
+    // should not be modified in the meantime.
+    bool thinking;
   };
 
   /// @brief - Convenience structure allowing to regroup all info about the menu
@@ -161,9 +208,23 @@ class Game : public utils::CoreObject
 
   /// @brief - The board for the current game.
   BoardShPtr m_board;
+
+  /// @brief - The kind of the engine picking the colors of the AI.
+  ai::Kind m_aiKind;
+
+  /// @brief - The engine picking the colors of the AI.
+  ai::EngineShPtr m_ai;
+
+  /// @brief - Searches the replies of the AI while the player is thinking.
+  ai::PondererShPtr m_ponderer;
+
+  /// @brief - The move of the AI, valid while it is thinking.
+  std::future<Color> m_aiMove;
 };
 
 using GameShPtr = std::shared_ptr<Game>;
+
+auto olcColorFromCellColor(const Color &c) -> olc::Pixel;
 } // namespace pge
 
 #include "Game.hxx"
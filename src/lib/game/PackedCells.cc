@@ -0,0 +1,220 @@
+
+#include "PackedCells.hh"
+#include "CellKernels.hh"
+#include <algorithm>
+
+namespace pge {
+namespace {
+
+using Word = PackedCells::Word;
+
+/// @brief - The mask of the bits of a word of a row corresponding to the
+/// columns in the range `[first, last)`.
+auto columns(int word, int first, int last) noexcept -> Word
+{
+  const auto below = [](const int count) {
+    return count >= 64 ? ~Word{0u} : (Word{1u} << count) - 1u;
+  };
+
+  const auto lo = std::clamp(first - word * 64, 0, 64);
+  const auto hi = std::clamp(last - word * 64, 0, 64);
+
+  return below(hi) & ~below(lo);
+}
+
+} // namespace
+
+PackedCells::PackedCells(int width, int height)
+  : m_width(width)
+  , m_height(height)
+  , m_stride((width + 2 * BORDER + 63) / 64)
+  , m_rows(height + 2 * BORDER)
+  , m_pitch(m_stride * 64)
+  , m_words(static_cast<std::size_t>(m_stride) * m_rows * SLICES, Word{0u})
+{
+  // All the cells start as sentinels, the cells of the grid being then
+  // given back to nobody.
+  std::array<Word, SLICES> slices{};
+
+  for (auto y = 0; y < m_rows; ++y)
+  {
+    const auto inside = (y >= BORDER && y < height + BORDER);
+
+    for (auto i = 0; i < m_stride; ++i)
+    {
+      const auto mask = (inside ? ~columns(i, BORDER, width + BORDER) : ~Word{0u});
+      slices[0]       = mask;
+      slices[1]       = mask;
+
+      writeStrip(y, i, slices.data());
+    }
+  }
+}
+
+bool PackedCells::loadRow(int y, const std::uint8_t *bytes) noexcept
+{
+  const auto chunks = (m_width + kernels::KERNEL_WIDTH - 1) / kernels::KERNEL_WIDTH;
+
+  std::array<Word, kernels::BYTE_BITS> slices{};
+  std::array<Word, SLICES> carry{}, strip;
+
+  auto invalid = Word{0u};
+  for (auto i = 0; i < m_stride; ++i)
+  {
+    if (i < chunks)
+    {
+      const auto count = std::min(kernels::KERNEL_WIDTH, m_width - i * kernels::KERNEL_WIDTH);
+      kernels::slice(bytes + i * kernels::KERNEL_WIDTH, count, slices);
+
+      // The bits past the ones of a cell should be empty, and no owner uses
+      // all the bits reserved for it.
+      for (auto b = SLICES; b < kernels::BYTE_BITS; ++b)
+      {
+        invalid |= slices[b];
+      }
+      invalid |= (slices[0] & slices[1]);
+    }
+    else
+    {
+      slices.fill(Word{0u});
+    }
+
+    // The cells of the row are shifted by the width of the border, which
+    // moves the last ones to the next strip.
+    for (auto b = 0; b < SLICES; ++b)
+    {
+      strip[b] = (slices[b] << BORDER) | carry[b];
+      carry[b] = slices[b] >> (64 - BORDER);
+    }
+
+    const auto border = ~columns(i, BORDER, m_width + BORDER);
+    strip[0] |= border;
+    strip[1] |= border;
+
+    writeStrip(y + BORDER, i, strip.data());
+  }
+
+  static_assert(OWNER_BITS == 2 && static_cast<int>(Owner::Count) == 3,
+                "Invalid owners are not detected");
+  static_assert(1 << COLOR_BITS == static_cast<int>(Color::Count),
+                "Invalid colors are not detected");
+
+  return invalid == Word{0u};
+}
+
+void PackedCells::storeRow(int y, std::uint8_t *bytes) const noexcept
+{
+  const auto chunks = (m_width + kernels::KERNEL_WIDTH - 1) / kernels::KERNEL_WIDTH;
+
+  std::array<Word, SLICES> strip, next, slices;
+  readStrip(y + BORDER, 0, next.data());
+
+  for (auto i = 0; i < chunks; ++i)
+  {
+    strip = next;
+    next.fill(Word{0u});
+    if (i + 1 < m_stride)
+    {
+      readStrip(y + BORDER, i + 1, next.data());
+    }
+
+    for (auto b = 0; b < SLICES; ++b)
+    {
+      slices[b] = (strip[b] >> BORDER) | (next[b] << (64 - BORDER));
+    }
+
+    const auto count = std::min(kernels::KERNEL_WIDTH, m_width - i * kernels::KERNEL_WIDTH);
+    kernels::unslice(slices.data(), SLICES, count, bytes + i * kernels::KERNEL_WIDTH);
+  }
+}
+
+int PackedCells::fill(int index,
+                      const Cell &cell,
+                      const Owner &owner,
+                      std::vector<int> &filled,
+                      std::vector<Seed> &pending) noexcept
+{
+  const auto value = static_cast<unsigned>(pack(cell));
+  auto out         = 0;
+
+  pending.clear();
+  pending.push_back(Seed{index / 64, Word{1u} << (index % 64)});
+
+  while (!pending.empty())
+  {
+    const auto [group, seeds] = pending.back();
+    pending.pop_back();
+
+    // Filled cells don't match anymore, which stops the fill from coming
+    // back to them. The border never matches either.
+    auto *slices      = &m_words[static_cast<std::size_t>(group) * SLICES];
+    const auto inside = match(slices, 0, SLICES, value);
+
+    auto bits = seeds & inside;
+    if (bits == Word{0u})
+    {
+      continue;
+    }
+
+    // Spreads the reached cells towards both ends of the word along the
+    // cells matching, doubling the distance covered at each step.
+    auto up       = bits;
+    auto down     = bits;
+    auto passUp   = inside;
+    auto passDown = inside;
+    for (auto shift = 1; shift < 64; shift *= 2)
+    {
+      up |= passUp & (up << shift);
+      down |= passDown & (down >> shift);
+      passUp &= passUp << shift;
+      passDown &= passDown >> shift;
+    }
+    bits = up | down;
+
+    for (auto b = 0; b < OWNER_BITS; ++b)
+    {
+      const auto set = ((static_cast<unsigned>(owner) >> b) & 1u) != 0u;
+      slices[b]      = set ? (slices[b] | bits) : (slices[b] & ~bits);
+    }
+
+    out += __builtin_popcountll(bits);
+    for (auto remaining = bits; remaining != Word{0u}; remaining &= remaining - 1u)
+    {
+      filled.push_back(group * 64 + __builtin_ctzll(remaining));
+    }
+
+    // The first and last cells of a row are part of the border: the fill
+    // never moves from one row to the next through the ends of the words.
+    const std::array<Seed, 4> next{Seed{group + 1, bits >> 63},
+                                   Seed{group - 1, bits << 63},
+                                   Seed{group + m_stride, bits},
+                                   Seed{group - m_stride, bits}};
+    for (const auto &seed : next)
+    {
+      if (seed.bits != Word{0u})
+      {
+        pending.push_back(seed);
+      }
+    }
+  }
+
+  return out;
+}
+
+auto PackedCells::bytes() const noexcept -> std::size_t
+{
+  return m_words.size() * sizeof(Word);
+}
+
+void PackedCells::readStrip(int y, int i, Word *slices) const noexcept
+{
+  const auto *words = &m_words[static_cast<std::size_t>(y * m_stride + i) * SLICES];
+  std::copy(words, words + SLICES, slices);
+}
+
+void PackedCells::writeStrip(int y, int i, const Word *slices) noexcept
+{
+  std::copy(slices, slices + SLICES, &m_words[static_cast<std::size_t>(y * m_stride + i) * SLICES]);
+}
+
+} // namespace pge
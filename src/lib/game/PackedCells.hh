@@ -0,0 +1,195 @@
+
+#pragma once
+
+#include "Cell.hh"
+#include <array>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace pge {
+
+/// @brief - A two dimensional grid of cells stored with 5 bits per cell: the
+/// owner takes 2 bits and the color 3 bits. Each bit of the cells is kept in
+/// its own slice of 64-bit words, and the slices of a given word are stored
+/// next to each other: reading a cell touches a single cache line, while a
+/// whole word of 64 cells can be compared against an owner or a color with a
+/// handful of bitwise operations.
+/// The grid is surrounded by a border of sentinel cells whose owner does
+/// not exist, which also fill the groups past the width and the height of
+/// the grid: they never match a real cell, so that the neighbors of any
+/// cell of the grid can be visited without checking the bounds. Besides the
+/// `(x, y)` interface, cells can be addressed by their index in the padded
+/// grid, from which the indices of the neighbors are computed without any
+/// branch.
+class PackedCells
+{
+  public:
+  using Word = std::uint64_t;
+
+  /// @brief - The number of bits used to store the owner of a cell.
+  static constexpr auto OWNER_BITS = 2;
+
+  /// @brief - The number of bits used to store the color of a cell.
+  static constexpr auto COLOR_BITS = 3;
+
+  /// @brief - The number of slices of words per group of 64 cells.
+  static constexpr auto SLICES = OWNER_BITS + COLOR_BITS;
+
+  /// @brief - The width of the border of sentinel cells around the grid.
+  static constexpr auto BORDER = 1;
+
+  /// @brief - The value of the owner bits of the sentinel cells.
+  static constexpr auto SENTINEL = (1u << OWNER_BITS) - 1u;
+
+  /// @brief - Cells of a group of 64 cells from which a `fill` continues.
+  struct Seed
+  {
+    int group;
+    Word bits;
+  };
+
+  /// @brief - Create an empty grid with no cells.
+  PackedCells() = default;
+
+  /// @brief - Create a grid with the specified dimensions where all the
+  /// cells are free and have the first color.
+  /// @param width - the width of the grid in cells.
+  /// @param height - the height of the grid in cells.
+  PackedCells(int width, int height);
+
+  int width() const noexcept;
+
+  int height() const noexcept;
+
+  Cell at(int x, int y) const noexcept;
+
+  auto owner(int x, int y) const noexcept -> Owner;
+
+  auto color(int x, int y) const noexcept -> Color;
+
+  /// @brief - Whether the cell at some coordinates has both the owner and
+  /// the color of the input cell. The coordinates may point to the border
+  /// of the grid, which never matches.
+  bool matches(int x, int y, const Cell &cell) const noexcept;
+
+  void set(int x, int y, const Cell &cell) noexcept;
+
+  /// @brief - Changes the owner of a cell, keeping its color.
+  void setOwner(int x, int y, const Owner &owner) noexcept;
+
+  /// @brief - The index of the cell at some coordinates in the padded grid.
+  /// @param x - the abscissa of the cell, between `-1` and the width.
+  /// @param y - the ordinate of the cell, between `-1` and the height.
+  /// @return - the index of the cell.
+  auto index(int x, int y) const noexcept -> int;
+
+  /// @brief - The reverse of `index`.
+  /// @param index - the index of a cell of the padded grid.
+  /// @return - the abscissa and ordinate of the cell.
+  auto position(int index) const noexcept -> std::pair<int, int>;
+
+  /// @brief - The indices of the right, left, bottom and top neighbors of
+  /// a cell of the grid.
+  /// @param index - the index of the cell.
+  /// @return - the indices of the neighbors.
+  auto neighborsOf(int index) const noexcept -> std::array<int, 4>;
+
+  /// @brief - Same as `matches` for the cell at some index.
+  bool matches(int index, const Cell &cell) const noexcept;
+
+  /// @brief - Same as `setOwner` for the cell at some index.
+  void setOwner(int index, const Owner &owner) noexcept;
+
+  /// @brief - Gives to an owner the cells which match a cell and can be
+  /// reached from a first one through such cells. The fill works on whole
+  /// groups of 64 cells: the cells of a group matching the input one are
+  /// found with a few bitwise operations, and the fill spreads along the
+  /// row with shifts of the mask of the reached cells. The reached cells
+  /// of a group then seed the groups on their left, right, top and bottom.
+  /// @param index - the index of the first cell, which should match `cell`.
+  /// @param cell - the owner and the color of the cells to fill.
+  /// @param owner - the new owner of the cells.
+  /// @param filled - output list where the indices of the filled cells are
+  /// appended.
+  /// @param pending - buffer used to store the groups left to fill.
+  /// @return - the number of cells filled.
+  int fill(int index,
+           const Cell &cell,
+           const Owner &owner,
+           std::vector<int> &filled,
+           std::vector<Seed> &pending) noexcept;
+
+  /// @brief - Packs a cell in a byte: the owner takes the low bits and the
+  /// color the following ones.
+  static auto pack(const Cell &cell) noexcept -> std::uint8_t;
+
+  /// @brief - The reverse of `pack`.
+  static auto unpack(std::uint8_t packed) noexcept -> Cell;
+
+  /// @brief - Replaces the cells of a row with packed bytes, 64 of them at a
+  /// time with the kernels of `CellKernels`. Different rows can be loaded
+  /// from different threads.
+  /// @param y - the index of the row.
+  /// @param bytes - the cells of the row as produced by `pack`: there should
+  /// be as many as the width of the grid.
+  /// @return - `false` if one of the bytes does not describe a valid cell,
+  /// in which case the row is left in an unspecified state.
+  bool loadRow(int y, const std::uint8_t *bytes) noexcept;
+
+  /// @brief - Packs the cells of a row into bytes, the reverse of `loadRow`.
+  /// @param y - the index of the row.
+  /// @param bytes - output bytes, as many as the width of the grid.
+  void storeRow(int y, std::uint8_t *bytes) const noexcept;
+
+  /// @brief - The memory used to store the cells.
+  /// @return - the size of the storage in bytes.
+  auto bytes() const noexcept -> std::size_t;
+
+  private:
+  int m_width{0};
+  int m_height{0};
+
+  /// @brief - The number of strips of 64 cells used to represent a row,
+  /// including the border.
+  int m_stride{0};
+
+  /// @brief - The number of rows stored, including the border.
+  int m_rows{0};
+
+  /// @brief - The distance between the indices of a cell and of the one
+  /// below it.
+  int m_pitch{0};
+
+  /// @brief - The slices of each group of 64 cells, stored one after the
+  /// other: the owner bits come first, followed by the color bits.
+  std::vector<Word> m_words{};
+
+  /// @brief - Reads the strip of 64 cells starting at the column `64 * i`
+  /// of the padded row `y`.
+  void readStrip(int y, int i, Word *slices) const noexcept;
+
+  /// @brief - Writes the strip of 64 cells starting at the column `64 * i`
+  /// of the padded row `y`.
+  void writeStrip(int y, int i, const Word *slices) noexcept;
+
+  /// @brief - The slices of the group of 64 cells containing an index.
+  auto slicesOf(int index) const noexcept -> const Word *;
+  auto slicesOf(int index) noexcept -> Word *;
+
+  /// @brief - The mask of the cells of a group whose bits in the slices
+  /// starting at `first` match the input value.
+  auto match(const Word *slices, int first, int bits, unsigned value) const noexcept -> Word;
+
+  /// @brief - Reads the value stored in the slices starting at `first` for
+  /// the cell at some index.
+  auto read(int index, int first, int bits) const noexcept -> unsigned;
+
+  /// @brief - Writes a value in the slices starting at `first` for the cell
+  /// at some index.
+  void write(int index, int first, int bits, unsigned value) noexcept;
+};
+
+} // namespace pge
+
+#include "PackedCells.hxx"
@@ -0,0 +1,147 @@
+
+#pragma once
+
+#include "PackedCells.hh"
+
+namespace pge {
+
+inline int PackedCells::width() const noexcept
+{
+  return m_width;
+}
+
+inline int PackedCells::height() const noexcept
+{
+  return m_height;
+}
+
+inline Cell PackedCells::at(int x, int y) const noexcept
+{
+  return Cell{owner(x, y), color(x, y)};
+}
+
+inline auto PackedCells::owner(int x, int y) const noexcept -> Owner
+{
+  return static_cast<Owner>(read(index(x, y), 0, OWNER_BITS));
+}
+
+inline auto PackedCells::color(int x, int y) const noexcept -> Color
+{
+  return static_cast<Color>(read(index(x, y), OWNER_BITS, COLOR_BITS));
+}
+
+inline bool PackedCells::matches(int x, int y, const Cell &cell) const noexcept
+{
+  return matches(index(x, y), cell);
+}
+
+inline void PackedCells::set(int x, int y, const Cell &cell) noexcept
+{
+  const auto id = index(x, y);
+  write(id, 0, OWNER_BITS, static_cast<unsigned>(cell.owner));
+  write(id, OWNER_BITS, COLOR_BITS, static_cast<unsigned>(cell.color));
+}
+
+inline void PackedCells::setOwner(int x, int y, const Owner &owner) noexcept
+{
+  setOwner(index(x, y), owner);
+}
+
+inline auto PackedCells::index(int x, int y) const noexcept -> int
+{
+  return (y + BORDER) * m_pitch + x + BORDER;
+}
+
+inline auto PackedCells::position(int index) const noexcept -> std::pair<int, int>
+{
+  return {index % m_pitch - BORDER, index / m_pitch - BORDER};
+}
+
+inline auto PackedCells::neighborsOf(int index) const noexcept -> std::array<int, 4>
+{
+  return {index + 1, index - 1, index + m_pitch, index - m_pitch};
+}
+
+inline bool PackedCells::matches(int index, const Cell &cell) const noexcept
+{
+  const auto value = static_cast<unsigned>(cell.owner)
+                     | (static_cast<unsigned>(cell.color) << OWNER_BITS);
+  return (match(slicesOf(index), 0, SLICES, value) >> (index % 64)) & 1u;
+}
+
+inline void PackedCells::setOwner(int index, const Owner &owner) noexcept
+{
+  write(index, 0, OWNER_BITS, static_cast<unsigned>(owner));
+}
+
+inline auto PackedCells::pack(const Cell &cell) noexcept -> std::uint8_t
+{
+  return static_cast<std::uint8_t>(static_cast<unsigned>(cell.owner)
+                                   | (static_cast<unsigned>(cell.color) << OWNER_BITS));
+}
+
+inline auto PackedCells::unpack(std::uint8_t packed) noexcept -> Cell
+{
+  constexpr auto OWNER_MASK = (1u << OWNER_BITS) - 1u;
+  return Cell{static_cast<Owner>(packed & OWNER_MASK), static_cast<Color>(packed >> OWNER_BITS)};
+}
+
+inline auto PackedCells::slicesOf(int index) const noexcept -> const Word *
+{
+  return &m_words[static_cast<std::size_t>(index / 64) * SLICES];
+}
+
+inline auto PackedCells::slicesOf(int index) noexcept -> Word *
+{
+  return &m_words[static_cast<std::size_t>(index / 64) * SLICES];
+}
+
+inline auto PackedCells::match(const Word *slices, int first, int bits, unsigned value) const noexcept
+  -> Word
+{
+  slices += first;
+
+  auto out = ~Word{0u};
+  for (auto b = 0; b < bits; ++b)
+  {
+    // Keeps the cells whose bit is equal to the bit of the value.
+    const auto expected = ((value >> b) & 1u) != 0u ? ~Word{0u} : Word{0u};
+    out &= ~(slices[b] ^ expected);
+  }
+
+  return out;
+}
+
+inline auto PackedCells::read(int index, int first, int bits) const noexcept -> unsigned
+{
+  const auto *slices = slicesOf(index) + first;
+  const auto shift   = index % 64;
+
+  auto out = 0u;
+  for (auto b = 0; b < bits; ++b)
+  {
+    out |= static_cast<unsigned>((slices[b] >> shift) & 1u) << b;
+  }
+
+  return out;
+}
+
+inline void PackedCells::write(int index, int first, int bits, unsigned value) noexcept
+{
+  auto *slices    = slicesOf(index) + first;
+  const auto mask = Word{1u} << (index % 64);
+
+  for (auto b = 0; b < bits; ++b)
+  {
+    if ((value >> b) & 1u)
+    {
+      slices[b] |= mask;
+    }
+    else
+    {
+      slices[b] &= ~mask;
+    }
+  }
+}
+
+} // namespace pge
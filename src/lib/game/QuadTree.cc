@@ -0,0 +1,294 @@
+
+#include "QuadTree.hh"
+#include <algorithm>
+#include <array>
+#include <istream>
+#include <ostream>
+
+namespace pge {
+
+QuadTree::QuadTree(int width, int height, const ValueAccessor &values)
+  : m_width(width)
+  , m_height(height)
+  , m_size(1)
+{
+  while (m_size < std::max(width, height))
+  {
+    m_size *= 2;
+  }
+
+  m_nodes.resize(1u);
+  build(0, 0, 0, m_size, values);
+}
+
+auto QuadTree::at(int x, int y) const noexcept -> Value
+{
+  auto node = 0;
+  auto size = m_size;
+  auto nx = 0, ny = 0;
+
+  while (m_nodes[node].children != LEAF)
+  {
+    size /= 2;
+    const auto right = (x >= nx + size);
+    const auto below = (y >= ny + size);
+
+    nx += right ? size : 0;
+    ny += below ? size : 0;
+    node = m_nodes[node].children + (right ? 1 : 0) + (below ? 2 : 0);
+  }
+
+  return m_nodes[node].value;
+}
+
+void QuadTree::set(int x, int y, Value value)
+{
+  // The depth of the tree is bounded by the number of bits of its size.
+  std::array<int, 32> path;
+  auto depth = 0;
+
+  auto node = 0;
+  auto size = m_size;
+  auto nx = 0, ny = 0;
+
+  while (true)
+  {
+    path[depth++] = node;
+
+    if (m_nodes[node].children == LEAF)
+    {
+      if (m_nodes[node].value == value)
+      {
+        return;
+      }
+      if (size == 1)
+      {
+        m_nodes[node].value = value;
+        break;
+      }
+
+      // A leaf is either inside or past the grid: its quadrants all keep
+      // its value.
+      const auto children = allocate();
+      for (auto c = 0; c < 4; ++c)
+      {
+        m_nodes[children + c] = Node{m_nodes[node].value, LEAF};
+      }
+      m_nodes[node].children = children;
+    }
+
+    size /= 2;
+    const auto right = (x >= nx + size);
+    const auto below = (y >= ny + size);
+
+    nx += right ? size : 0;
+    ny += below ? size : 0;
+    node = m_nodes[node].children + (right ? 1 : 0) + (below ? 2 : 0);
+  }
+
+  // The blocks holding the cell may have become uniform.
+  for (auto d = depth - 2; d >= 0 && merge(path[d]); --d)
+  {}
+}
+
+void QuadTree::compact()
+{
+  if (m_nodes.empty() || 4u * m_free.size() <= m_nodes.size() / 2u)
+  {
+    return;
+  }
+
+  QuadTree out;
+  out.m_width  = m_width;
+  out.m_height = m_height;
+  out.m_size   = m_size;
+  out.m_nodes.reserve(static_cast<std::size_t>(nodes()));
+  out.m_nodes.resize(1u);
+  out.copy(*this, 0, 0);
+
+  *this = std::move(out);
+}
+
+int QuadTree::nodes() const noexcept
+{
+  return static_cast<int>(m_nodes.size() - 4u * m_free.size());
+}
+
+auto QuadTree::bytes() const noexcept -> std::size_t
+{
+  return m_nodes.size() * sizeof(Node) + m_free.size() * sizeof(int);
+}
+
+void QuadTree::save(std::ostream &out) const
+{
+  if (!m_nodes.empty())
+  {
+    write(0, out);
+  }
+}
+
+bool QuadTree::load(std::istream &in, int width, int height)
+{
+  m_width  = width;
+  m_height = height;
+  m_size   = 1;
+  while (m_size < std::max(width, height))
+  {
+    m_size *= 2;
+  }
+
+  m_nodes.assign(1u, Node{OUTSIDE, LEAF});
+  m_free.clear();
+
+  if (!read(0, 0, 0, m_size, in))
+  {
+    *this = QuadTree();
+    return false;
+  }
+
+  return true;
+}
+
+auto QuadTree::allocate() -> int
+{
+  if (!m_free.empty())
+  {
+    const auto out = m_free.back();
+    m_free.pop_back();
+    return out;
+  }
+
+  const auto out = static_cast<int>(m_nodes.size());
+  m_nodes.resize(m_nodes.size() + 4u);
+  return out;
+}
+
+void QuadTree::build(int node, int x, int y, int size, const ValueAccessor &values)
+{
+  if (outside(x, y))
+  {
+    m_nodes[node] = Node{OUTSIDE, LEAF};
+    return;
+  }
+  if (size == 1)
+  {
+    m_nodes[node] = Node{values(x, y), LEAF};
+    return;
+  }
+
+  const auto children    = allocate();
+  m_nodes[node].children = children;
+
+  const auto half = size / 2;
+  build(children, x, y, half, values);
+  build(children + 1, x + half, y, half, values);
+  build(children + 2, x, y + half, half, values);
+  build(children + 3, x + half, y + half, half, values);
+
+  merge(node);
+}
+
+void QuadTree::copy(const QuadTree &from, int source, int node)
+{
+  const auto &n = from.m_nodes[source];
+  if (n.children == LEAF)
+  {
+    m_nodes[node] = n;
+    return;
+  }
+
+  const auto children = allocate();
+  m_nodes[node]       = Node{n.value, children};
+  for (auto c = 0; c < 4; ++c)
+  {
+    copy(from, n.children + c, children + c);
+  }
+}
+
+void QuadTree::write(int node, std::ostream &out) const
+{
+  const auto &n = m_nodes[node];
+  if (n.children == LEAF)
+  {
+    out.put(static_cast<char>(n.value));
+    return;
+  }
+
+  out.put(static_cast<char>(SPLIT));
+  for (auto c = 0; c < 4; ++c)
+  {
+    write(n.children + c, out);
+  }
+}
+
+bool QuadTree::read(int node, int x, int y, int size, std::istream &in)
+{
+  const auto raw = in.get();
+  if (raw == std::istream::traits_type::eof())
+  {
+    return false;
+  }
+
+  const auto value = static_cast<Value>(raw);
+  if (value != SPLIT)
+  {
+    // A leaf is either entirely past the grid or entirely inside it.
+    const auto past   = outside(x, y);
+    const auto inside = (x + size <= m_width && y + size <= m_height);
+
+    m_nodes[node] = Node{value, LEAF};
+    return (value == OUTSIDE ? past : inside);
+  }
+
+  if (size == 1)
+  {
+    return false;
+  }
+
+  const auto children    = allocate();
+  m_nodes[node].children = children;
+
+  const auto half = size / 2;
+  const auto ok   = read(children, x, y, half, in) && read(children + 1, x + half, y, half, in)
+                  && read(children + 2, x, y + half, half, in)
+                  && read(children + 3, x + half, y + half, half, in);
+
+  // Trees written by `save` never have uniform split nodes, but nothing
+  // prevents other files to hold some.
+  if (ok)
+  {
+    merge(node);
+  }
+
+  return ok;
+}
+
+bool QuadTree::merge(int node)
+{
+  const auto children = m_nodes[node].children;
+  const auto value    = m_nodes[children].value;
+
+  for (auto c = 0; c < 4; ++c)
+  {
+    if (m_nodes[children + c].children != LEAF || m_nodes[children + c].value != value)
+    {
+      return false;
+    }
+  }
+
+  m_nodes[node] = Node{value, LEAF};
+
+  // The quadrants are usually the last nodes when the tree is built.
+  if (children + 4u == m_nodes.size())
+  {
+    m_nodes.resize(m_nodes.size() - 4u);
+  }
+  else
+  {
+    m_free.push_back(children);
+  }
+
+  return true;
+}
+
+} // namespace pge
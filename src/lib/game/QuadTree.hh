@@ -0,0 +1,141 @@
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <iosfwd>
+#include <vector>
+
+namespace pge {
+
+/// @brief - A region quadtree over a grid of small values: the square
+/// covering the grid is split in four quadrants until each block holds a
+/// single value, so that large uniform areas collapse into a single node.
+/// The memory used and the cost of visiting the blocks are proportional to
+/// the length of the boundaries between the values rather than to the area
+/// of the grid.
+/// The square covering the grid has a power of two size: the cells past
+/// the dimensions of the grid hold the `OUTSIDE` value and are never
+/// visited.
+class QuadTree
+{
+  public:
+  using Value = std::uint8_t;
+
+  /// @brief - Convenience define to access the values of a grid.
+  using ValueAccessor = std::function<Value(int, int)>;
+
+  /// @brief - The value of the cells past the dimensions of the grid.
+  static constexpr Value OUTSIDE = 0xFF;
+
+  /// @brief - Marks a node split in quadrants in the serialized trees.
+  static constexpr Value SPLIT = 0xFE;
+
+  /// @brief - Create an empty tree with no cells.
+  QuadTree() = default;
+
+  /// @brief - Build the tree of the grid described by the input accessor,
+  /// which is called once per cell.
+  /// @param width - the width of the grid.
+  /// @param height - the height of the grid.
+  /// @param values - a function returning the value at some coordinates,
+  /// which should be neither `OUTSIDE` nor `SPLIT`.
+  QuadTree(int width, int height, const ValueAccessor &values);
+
+  int width() const noexcept;
+
+  int height() const noexcept;
+
+  auto at(int x, int y) const noexcept -> Value;
+
+  /// @brief - Changes the value of a cell, splitting the block holding it
+  /// and merging back the blocks which become uniform. This costs a number
+  /// of operations proportional to the depth of the tree.
+  /// @param x - the abscissa of the cell.
+  /// @param y - the ordinate of the cell.
+  /// @param value - the new value of the cell.
+  void set(int x, int y, Value value);
+
+  /// @brief - Releases the memory of the nodes freed by the merges when
+  /// they outnumber the nodes still in use, by copying the tree. As the
+  /// territories grow, this keeps the memory proportional to their
+  /// boundaries.
+  void compact();
+
+  /// @brief - The number of nodes of the tree.
+  int nodes() const noexcept;
+
+  /// @brief - The memory used to store the nodes.
+  /// @return - the size of the storage in bytes.
+  auto bytes() const noexcept -> std::size_t;
+
+  /// @brief - Calls the visitor for each uniform block of the grid, with
+  /// the coordinates of its top left corner, its size and its value.
+  /// @param visitor - a callable taking `(x, y, size, value)`.
+  template<typename Visitor>
+  void visit(Visitor &&visitor) const;
+
+  /// @brief - Writes the nodes of the tree in prefix order: a leaf is
+  /// written as its value and a split node as `SPLIT` followed by its
+  /// quadrants.
+  /// @param out - the stream to write to.
+  void save(std::ostream &out) const;
+
+  /// @brief - Reads a tree written by `save`.
+  /// @param in - the stream to read from.
+  /// @param width - the width of the grid.
+  /// @param height - the height of the grid.
+  /// @return - `false` if the stream does not hold a valid tree for these
+  /// dimensions, in which case the tree is left empty.
+  bool load(std::istream &in, int width, int height);
+
+  private:
+  /// @brief - A node of the tree. The quadrants of a split node are stored
+  /// next to each other, in reading order.
+  struct Node
+  {
+    Value value;
+    int children;
+  };
+
+  /// @brief - Identifies a node without quadrants.
+  static constexpr auto LEAF = -1;
+
+  int m_width{0};
+  int m_height{0};
+
+  /// @brief - The size of the square covering the grid.
+  int m_size{0};
+
+  /// @brief - The nodes of the tree, the root coming first.
+  std::vector<Node> m_nodes{};
+
+  /// @brief - The first node of groups of four nodes released by merges,
+  /// reused by the following splits.
+  std::vector<int> m_free{};
+
+  /// @brief - Whether a block starting at some coordinates lies entirely
+  /// past the dimensions of the grid.
+  bool outside(int x, int y) const noexcept;
+
+  /// @brief - Reserves four consecutive nodes for the quadrants of a node.
+  /// @return - the index of the first of them.
+  auto allocate() -> int;
+
+  void build(int node, int x, int y, int size, const ValueAccessor &values);
+  void copy(const QuadTree &from, int source, int node);
+  void write(int node, std::ostream &out) const;
+  bool read(int node, int x, int y, int size, std::istream &in);
+
+  /// @brief - Turns a node into a leaf if its quadrants are leaves with the
+  /// same value, releasing them.
+  /// @return - whether the node was merged.
+  bool merge(int node);
+
+  template<typename Visitor>
+  void visit(int node, int x, int y, int size, Visitor &visitor) const;
+};
+
+} // namespace pge
+
+#include "QuadTree.hxx"
@@ -0,0 +1,53 @@
+
+#pragma once
+
+#include "QuadTree.hh"
+
+namespace pge {
+
+inline int QuadTree::width() const noexcept
+{
+  return m_width;
+}
+
+inline int QuadTree::height() const noexcept
+{
+  return m_height;
+}
+
+template<typename Visitor>
+inline void QuadTree::visit(Visitor &&visitor) const
+{
+  if (!m_nodes.empty())
+  {
+    visit(0, 0, 0, m_size, visitor);
+  }
+}
+
+inline bool QuadTree::outside(int x, int y) const noexcept
+{
+  return x >= m_width || y >= m_height;
+}
+
+template<typename Visitor>
+inline void QuadTree::visit(int node, int x, int y, int size, Visitor &visitor) const
+{
+  const auto &n = m_nodes[node];
+  if (n.children == LEAF)
+  {
+    if (n.value != OUTSIDE)
+    {
+      visitor(x, y, size, n.value);
+    }
+
+    return;
+  }
+
+  const auto half = size / 2;
+  visit(n.children, x, y, half, visitor);
+  visit(n.children + 1, x + half, y, half, visitor);
+  visit(n.children + 2, x, y + half, half, visitor);
+  visit(n.children + 3, x + half, y + half, half, visitor);
+}
+
+} // namespace pge
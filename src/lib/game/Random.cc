@@ -0,0 +1,49 @@
+
+#include "Random.hh"
+#include "Cell.hh"
+
+namespace pge {
+namespace {
+
+/// @brief - The number of bits needed to describe a color.
+constexpr auto COLOR_BITS = 3;
+
+/// @brief - The number of colors extracted from a word of random bits.
+constexpr auto COLORS_PER_WORD = 64 / COLOR_BITS;
+
+static_assert(1 << COLOR_BITS == static_cast<int>(Color::Count),
+              "The random bits should map to all the colors");
+
+} // namespace
+
+void generateColors(std::uint64_t seed,
+                    std::uint64_t stream,
+                    int count,
+                    std::uint8_t *colors) noexcept
+{
+  constexpr auto COLOR_MASK = (1u << COLOR_BITS) - 1u;
+  const auto key            = randomBits(seed, stream);
+
+  // Full words are unrolled by the compiler, leaving a partial word at the
+  // end of the stream.
+  auto word = 0;
+  for (; (word + 1) * COLORS_PER_WORD <= count; ++word)
+  {
+    const auto bits = randomBits(key, static_cast<std::uint64_t>(word));
+    auto *out       = colors + word * COLORS_PER_WORD;
+
+    for (auto id = 0; id < COLORS_PER_WORD; ++id)
+    {
+      out[id] = static_cast<std::uint8_t>((bits >> (id * COLOR_BITS)) & COLOR_MASK);
+    }
+  }
+
+  const auto bits = randomBits(key, static_cast<std::uint64_t>(word));
+  for (auto id = word * COLORS_PER_WORD; id < count; ++id)
+  {
+    const auto shift = (id - word * COLORS_PER_WORD) * COLOR_BITS;
+    colors[id]       = static_cast<std::uint8_t>((bits >> shift) & COLOR_MASK);
+  }
+}
+
+} // namespace pge
@@ -0,0 +1,45 @@
+
+#pragma once
+
+#include <cstdint>
+
+namespace pge {
+
+/// @brief - Scrambles the bits of a value, with the finalizer of the
+/// splitmix64 generator: consecutive inputs give unrelated outputs.
+/// @param value - the value to scramble.
+/// @return - the scrambled value.
+inline auto scramble(std::uint64_t value) noexcept -> std::uint64_t
+{
+  value += 0x9E3779B97F4A7C15ull;
+  value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+  value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+  return value ^ (value >> 31);
+}
+
+/// @brief - A counter-based generator: the random bits at some position of
+/// a stream are computed directly from the seed, the stream and the
+/// position. Streams can then be generated in any order and from any
+/// number of threads, always giving the same values.
+/// @param seed - the seed of the generator.
+/// @param counter - the position in the stream.
+/// @return - 64 random bits.
+inline auto randomBits(std::uint64_t seed, std::uint64_t counter) noexcept -> std::uint64_t
+{
+  return scramble(seed ^ scramble(counter));
+}
+
+/// @brief - Generates random colors, 21 of them for each word of random
+/// bits. The color at some index only depends on the seed, on the stream
+/// and on the index.
+/// @param seed - the seed of the generator.
+/// @param stream - identifies the sequence of colors, such as a row of a
+/// board.
+/// @param count - the number of colors to generate.
+/// @param colors - output colors, as the values of the `Color` enumeration.
+void generateColors(std::uint64_t seed,
+                    std::uint64_t stream,
+                    int count,
+                    std::uint8_t *colors) noexcept;
+
+} // namespace pge
@@ -0,0 +1,738 @@
+
+#include "RegionGraph.hh"
+#include "Random.hh"
+#include <algorithm>
+
+namespace pge {
+namespace {
+
+/// @brief - Whether two neighboring cells belong to the same region.
+bool sameRegion(const Cell &lhs, const Cell &rhs) noexcept
+{
+  return lhs.owner == rhs.owner && (lhs.owner != Owner::Nobody || lhs.color == rhs.color);
+}
+
+/// @brief - The bit used to mark the regions of the frontier of an owner.
+auto memberBit(const Owner &owner) noexcept -> std::uint8_t
+{
+  return static_cast<std::uint8_t>(1u << static_cast<int>(owner));
+}
+
+/// @brief - The index of the Zobrist key of the color of the territory of
+/// an owner.
+auto colorIndex(const Owner &owner, const Color &color) noexcept -> int
+{
+  return static_cast<int>(owner) * static_cast<int>(Color::Count) + static_cast<int>(color);
+}
+
+/// @brief - Finds the root of the set of the input element, halving the
+/// path along the way. The root of a set is always its smallest element.
+int find(std::vector<int> &parents, int id) noexcept
+{
+  while (parents[id] != id)
+  {
+    parents[id] = parents[parents[id]];
+    id          = parents[id];
+  }
+
+  return id;
+}
+
+void unite(std::vector<int> &parents, int lhs, int rhs) noexcept
+{
+  lhs = find(parents, lhs);
+  rhs = find(parents, rhs);
+
+  if (lhs < rhs)
+  {
+    parents[rhs] = lhs;
+  }
+  else if (rhs < lhs)
+  {
+    parents[lhs] = rhs;
+  }
+}
+
+} // namespace
+
+RegionGraph::RegionGraph(int width, int height, const CellAccessor &cells)
+  : RegionGraph(width, height, cells, width, height)
+{}
+
+RegionGraph::RegionGraph(int width,
+                         int height,
+                         const CellAccessor &cells,
+                         int fullWidth,
+                         int fullHeight)
+{
+  buildRegions(width, height, cells, fullWidth, fullHeight);
+  buildFrontiers();
+  buildHash();
+}
+
+int RegionGraph::size() const noexcept
+{
+  return static_cast<int>(m_topology->regions.size());
+}
+
+auto RegionGraph::region(int id) const noexcept -> const Region &
+{
+  return m_topology->regions[id];
+}
+
+auto RegionGraph::owner(int id) const noexcept -> Owner
+{
+  return m_owners[id];
+}
+
+int RegionGraph::outside() const noexcept
+{
+  return m_topology->outside;
+}
+
+bool RegionGraph::exposed() const noexcept
+{
+  const auto &topology = *m_topology;
+  const auto id        = topology.outside;
+  if (id < 0)
+  {
+    return false;
+  }
+  if (m_members[id] != 0u)
+  {
+    return true;
+  }
+
+  for (auto n = topology.offsets[id]; n < topology.offsets[id + 1]; ++n)
+  {
+    if (m_members[topology.neighbors[n]] != 0u)
+    {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+auto RegionGraph::color(const Owner &owner) const noexcept -> Color
+{
+  return m_colors[static_cast<int>(owner)];
+}
+
+int RegionGraph::count(const Owner &owner) const noexcept
+{
+  return m_counts[static_cast<int>(owner)];
+}
+
+int RegionGraph::contested() const noexcept
+{
+  return m_contested;
+}
+
+int RegionGraph::gain(const Owner &owner, const Color &color) const noexcept
+{
+  return m_frontiers[static_cast<int>(owner)].gains[static_cast<int>(color)];
+}
+
+bool RegionGraph::inContact() const noexcept
+{
+  return m_inContact;
+}
+
+auto RegionGraph::hash() const noexcept -> std::uint64_t
+{
+  return m_hash;
+}
+
+auto RegionGraph::fingerprint() const noexcept -> std::uint64_t
+{
+  return m_topology->fingerprint;
+}
+
+bool RegionGraph::decided(std::array<int, static_cast<int>(Owner::Count)> &finals) const
+{
+  // Without free regions touching the territories, nothing can be gained.
+  // The outside is not counted as contested: the territories touching it
+  // still get its cells.
+  const auto outside = m_topology->outside;
+  if (m_contested == 0 && (outside < 0 || m_members[outside] == 0u))
+  {
+    finals = m_counts;
+    return true;
+  }
+
+  if (linked(m_witness))
+  {
+    return false;
+  }
+
+  const auto &topology = *m_topology;
+
+  ++m_searches;
+  m_reached.assign(m_owners.size(), 0u);
+  m_parents.resize(m_owners.size());
+  m_pending.clear();
+  auto out = m_counts;
+
+  // The region reached from both sides, and the region it was reached from
+  // by the search of the AI.
+  auto meeting = -1;
+  auto from    = -1;
+
+  for (const auto &owner : {Owner::Player, Owner::AI})
+  {
+    const auto bit = memberBit(owner);
+
+    // A region already reached from the other side can be gained by both.
+    const auto reach = [&](const int id, const int parent) {
+      if (m_owners[id] != Owner::Nobody || (m_reached[id] & bit))
+      {
+        return true;
+      }
+      if (m_reached[id] != 0u)
+      {
+        meeting = id;
+        from    = parent;
+        return false;
+      }
+
+      m_reached[id] |= bit;
+      m_parents[id] = parent;
+      m_pending.push_back(id);
+      out[static_cast<int>(owner)] += topology.regions[id].size;
+      out[static_cast<int>(Owner::Nobody)] -= topology.regions[id].size;
+
+      return true;
+    };
+
+    for (auto id = 0; id < size() && meeting < 0; ++id)
+    {
+      if (m_members[id] & bit)
+      {
+        reach(id, -1);
+      }
+    }
+
+    while (!m_pending.empty() && meeting < 0)
+    {
+      const auto id = m_pending.back();
+      m_pending.pop_back();
+
+      for (auto n = topology.offsets[id]; n < topology.offsets[id + 1] && meeting < 0; ++n)
+      {
+        reach(topology.neighbors[n], id);
+      }
+    }
+  }
+
+  if (meeting < 0)
+  {
+    m_witness.clear();
+    finals = out;
+    return true;
+  }
+
+  // The chain goes back from the meeting region to the territory of the
+  // player, and then from the region the AI came from to its territory.
+  m_witness.clear();
+  for (auto id = meeting; id >= 0; id = m_parents[id])
+  {
+    m_witness.push_back(id);
+  }
+  std::reverse(m_witness.begin(), m_witness.end());
+  for (auto id = from; id >= 0; id = m_parents[id])
+  {
+    m_witness.push_back(id);
+  }
+
+  return false;
+}
+
+int RegionGraph::searches() const noexcept
+{
+  return m_searches;
+}
+
+bool RegionGraph::canPick(const Owner &owner, const Color &color) const noexcept
+{
+  if (color == m_colors[static_cast<int>(owner)])
+  {
+    return false;
+  }
+
+  return !m_inContact || color != m_colors[static_cast<int>(opponentOf(owner))];
+}
+
+auto RegionGraph::bestColor(const Owner &owner) const noexcept -> Color
+{
+  auto best = Color::Count;
+  for (auto cId = 0; cId < static_cast<int>(Color::Count); ++cId)
+  {
+    const auto color = static_cast<Color>(cId);
+    if (canPick(owner, color) && (best == Color::Count || gain(owner, color) > gain(owner, best)))
+    {
+      best = color;
+    }
+  }
+
+  if (gain(owner, best) > 0)
+  {
+    return best;
+  }
+
+  constexpr auto TRIES_FOR_RANDOM_COLOR = static_cast<int>(Color::Count);
+  for (auto tries = 0; tries < TRIES_FOR_RANDOM_COLOR; ++tries)
+  {
+    const auto draw = static_cast<std::uint64_t>(history()) * TRIES_FOR_RANDOM_COLOR + tries;
+    const auto pick = static_cast<Color>(randomBits(fingerprint(), draw) % TRIES_FOR_RANDOM_COLOR);
+    if (canPick(owner, pick))
+    {
+      return pick;
+    }
+  }
+
+  return best;
+}
+
+void RegionGraph::absorb(const Owner &owner, const Color &color, std::vector<int> &absorbed)
+{
+  const auto other     = opponentOf(owner);
+  const auto &topology = *m_topology;
+  auto &frontier       = m_frontiers[static_cast<int>(owner)];
+  auto &opponent       = m_frontiers[static_cast<int>(other)];
+  const auto c         = static_cast<int>(color);
+
+  auto &bucket = frontier.regions[c];
+
+  m_changes.push_back(Change{owner,
+                             m_colors[static_cast<int>(owner)],
+                             color,
+                             m_inContact,
+                             frontier.gains[c],
+                             static_cast<int>(m_journal.size()),
+                             static_cast<int>(bucket.size())});
+  m_journal.insert(m_journal.end(), bucket.begin(), bucket.end());
+
+  m_hash ^= colorKey(owner, m_colors[static_cast<int>(owner)]) ^ colorKey(owner, color);
+  m_colors[static_cast<int>(owner)] = color;
+
+  // The regions of the bucket are all absorbed: as two free regions with
+  // the same color can't touch, none of their neighbors can be absorbed in
+  // the same move and the bucket does not receive new regions.
+  for (const auto &id : bucket)
+  {
+    if (m_owners[id] != Owner::Nobody)
+    {
+      continue;
+    }
+
+    const auto &region = topology.regions[id];
+    m_owners[id]       = owner;
+    m_hash ^= key(id, owner);
+    absorbed.push_back(id);
+    m_journal.push_back(-id - 1);
+
+    m_counts[static_cast<int>(Owner::Nobody)] -= region.size;
+    m_counts[static_cast<int>(owner)] += region.size;
+    m_contested -= region.size;
+
+    if (m_members[id] & memberBit(other))
+    {
+      opponent.gains[c] -= region.size;
+    }
+
+    for (auto n = topology.offsets[id]; n < topology.offsets[id + 1]; ++n)
+    {
+      const auto neighbor = topology.neighbors[n];
+      const auto &o       = m_owners[neighbor];
+
+      if (o == other)
+      {
+        m_inContact = true;
+      }
+      else if (o == Owner::Nobody && registerInFrontier(owner, neighbor))
+      {
+        m_journal.push_back(neighbor);
+      }
+    }
+  }
+
+  bucket.clear();
+  frontier.gains[c] = 0;
+}
+
+int RegionGraph::history() const noexcept
+{
+  return static_cast<int>(m_changes.size());
+}
+
+auto RegionGraph::undo(std::vector<int> &released) -> Owner
+{
+  if (m_changes.empty())
+  {
+    return Owner::Nobody;
+  }
+
+  const auto change    = m_changes.back();
+  const auto other     = opponentOf(change.owner);
+  const auto &topology = *m_topology;
+  auto &frontier       = m_frontiers[static_cast<int>(change.owner)];
+  auto &opponent       = m_frontiers[static_cast<int>(other)];
+  const auto c         = static_cast<int>(change.color);
+  const auto end       = change.start + change.bucket;
+
+  m_changes.pop_back();
+
+  // Walk the journal backwards so that each region registered in a bucket
+  // is the last one of this bucket when it is removed.
+  for (auto j = static_cast<int>(m_journal.size()) - 1; j >= end; --j)
+  {
+    const auto entry = m_journal[j];
+    if (entry >= 0)
+    {
+      unregisterFromFrontier(change.owner, entry);
+      continue;
+    }
+
+    const auto id      = -entry - 1;
+    const auto &region = topology.regions[id];
+    m_owners[id]       = Owner::Nobody;
+    m_hash ^= key(id, change.owner);
+    released.push_back(id);
+
+    m_counts[static_cast<int>(Owner::Nobody)] += region.size;
+    m_counts[static_cast<int>(change.owner)] -= region.size;
+    m_contested += region.size;
+
+    if (m_members[id] & memberBit(other))
+    {
+      opponent.gains[c] += region.size;
+    }
+  }
+
+  frontier.regions[c].assign(m_journal.begin() + change.start, m_journal.begin() + end);
+  frontier.gains[c] = change.gain;
+  m_journal.resize(change.start);
+
+  m_inContact = change.inContact;
+  m_hash ^= colorKey(change.owner, change.color) ^ colorKey(change.owner, change.previous);
+  m_colors[static_cast<int>(change.owner)] = change.previous;
+
+  return change.owner;
+}
+
+void RegionGraph::buildRegions(int width,
+                               int height,
+                               const CellAccessor &cells,
+                               int fullWidth,
+                               int fullHeight)
+{
+  const auto count = width * height;
+
+  // Group the cells: each cell is compared to its left and top neighbors,
+  // keeping the previous row around to only query each cell once.
+  std::vector<int> labels(count);
+  std::vector<Cell> row(width), previous(width);
+
+  for (auto y = 0; y < height; ++y)
+  {
+    for (auto x = 0; x < width; ++x)
+    {
+      const auto id = y * width + x;
+      row[x]        = cells(x, y);
+      labels[id]    = id;
+
+      if (x > 0 && sameRegion(row[x], row[x - 1]))
+      {
+        unite(labels, id, id - 1);
+      }
+      if (y > 0 && sameRegion(row[x], previous[x]))
+      {
+        unite(labels, id, id - width);
+      }
+    }
+
+    row.swap(previous);
+  }
+
+  // As the parent of a cell always comes before it, a single ascending pass
+  // is enough to replace the parents by the region identifiers.
+  auto topology = std::make_shared<Topology>();
+  std::array<bool, static_cast<int>(Owner::Count)> colored{};
+
+  for (auto id = 0; id < count; ++id)
+  {
+    if (labels[id] == id)
+    {
+      const auto cell = cells(id % width, id / width);
+      const auto o    = static_cast<int>(cell.owner);
+
+      labels[id] = static_cast<int>(topology->regions.size());
+      topology->regions.push_back(Region{0, cell.color, id});
+      m_owners.push_back(cell.owner);
+
+      if (!colored[o])
+      {
+        m_colors[o] = cell.color;
+        colored[o]  = true;
+      }
+    }
+    else
+    {
+      labels[id] = labels[labels[id]];
+    }
+
+    ++topology->regions[labels[id]].size;
+    ++m_counts[static_cast<int>(m_owners[labels[id]])];
+  }
+
+  const auto outside = fullWidth * fullHeight - count;
+  if (outside > 0)
+  {
+    topology->outside = static_cast<int>(topology->regions.size());
+    topology->regions.push_back(Region{outside, Color::Count, count});
+    m_owners.push_back(Owner::Nobody);
+    m_counts[static_cast<int>(Owner::Nobody)] += outside;
+  }
+
+  buildNeighbors(width, height, labels, fullWidth > width, fullHeight > height, *topology);
+  buildKeys(width, height, *topology);
+
+  m_topology = topology;
+}
+
+void RegionGraph::buildNeighbors(int width,
+                                 int height,
+                                 const std::vector<int> &labels,
+                                 bool right,
+                                 bool bottom,
+                                 Topology &topology) const
+{
+  // Collect the pairs of different regions touching each other. Pairs
+  // repeated along a border are mostly consecutive: they are skipped by
+  // remembering the last neighbor registered for each region.
+  std::vector<int> last(topology.regions.size(), -1);
+  std::vector<std::pair<int, int>> pairs;
+
+  const auto connect = [&last, &pairs](const int lhs, const int rhs) {
+    if (lhs == rhs || last[lhs] == rhs)
+    {
+      return;
+    }
+
+    last[lhs] = rhs;
+    last[rhs] = lhs;
+    pairs.emplace_back(lhs, rhs);
+    pairs.emplace_back(rhs, lhs);
+  };
+
+  for (auto y = 0; y < height; ++y)
+  {
+    for (auto x = 0; x < width; ++x)
+    {
+      const auto id = y * width + x;
+      if (x + 1 < width)
+      {
+        connect(labels[id], labels[id + 1]);
+      }
+      if (y + 1 < height)
+      {
+        connect(labels[id], labels[id + width]);
+      }
+
+      // The outside lies past the right and bottom edges, when the board
+      // extends in these directions.
+      if ((right && x + 1 == width) || (bottom && y + 1 == height))
+      {
+        connect(labels[id], topology.outside);
+      }
+    }
+  }
+
+  std::sort(pairs.begin(), pairs.end());
+  pairs.erase(std::unique(pairs.begin(), pairs.end()), pairs.end());
+
+  topology.offsets.assign(topology.regions.size() + 1u, 0);
+  topology.neighbors.resize(pairs.size());
+
+  for (auto id = 0u; id < pairs.size(); ++id)
+  {
+    ++topology.offsets[pairs[id].first + 1];
+    topology.neighbors[id] = pairs[id].second;
+  }
+  for (auto id = 1u; id < topology.offsets.size(); ++id)
+  {
+    topology.offsets[id] += topology.offsets[id - 1];
+  }
+}
+
+void RegionGraph::buildKeys(int width, int height, Topology &topology) const
+{
+  // The fingerprint folds the regions as they were when the graph was
+  // built, along with their neighbors.
+  const auto dims = static_cast<std::uint64_t>(width) << 32 | static_cast<std::uint32_t>(height);
+  auto fingerprint = scramble(dims);
+  const auto fold  = [&fingerprint](const std::uint64_t value) {
+    fingerprint = scramble(fingerprint ^ value);
+  };
+
+  for (auto id = 0u; id < topology.regions.size(); ++id)
+  {
+    const auto &region = topology.regions[id];
+    fold(static_cast<std::uint64_t>(region.size) << 32 | static_cast<std::uint32_t>(region.seed));
+    fold(static_cast<std::uint64_t>(region.color) << 8 | static_cast<std::uint64_t>(m_owners[id]));
+  }
+  for (const auto neighbor : topology.neighbors)
+  {
+    fold(static_cast<std::uint64_t>(neighbor));
+  }
+
+  topology.fingerprint = fingerprint;
+
+  // The keys of the colors are taken past the range used by the regions.
+  topology.keys.resize(topology.regions.size() * static_cast<int>(Owner::Count));
+  for (auto id = 0u; id < topology.keys.size(); ++id)
+  {
+    topology.keys[id] = randomBits(fingerprint, id);
+  }
+  for (auto id = 0u; id < topology.colorKeys.size(); ++id)
+  {
+    topology.colorKeys[id] = randomBits(fingerprint, ~static_cast<std::uint64_t>(id));
+  }
+}
+
+void RegionGraph::buildFrontiers()
+{
+  const auto &topology = *m_topology;
+
+  m_members.assign(topology.regions.size(), 0u);
+  m_inContact = false;
+
+  for (auto id = 0; id < size(); ++id)
+  {
+    const auto owner = m_owners[id];
+    if (owner == Owner::Nobody)
+    {
+      continue;
+    }
+
+    for (auto n = topology.offsets[id]; n < topology.offsets[id + 1]; ++n)
+    {
+      const auto neighbor = topology.neighbors[n];
+      const auto &o       = m_owners[neighbor];
+
+      if (o == Owner::Nobody)
+      {
+        registerInFrontier(owner, neighbor);
+      }
+      else if (o != owner)
+      {
+        m_inContact = true;
+      }
+    }
+  }
+}
+
+void RegionGraph::buildHash()
+{
+  m_hash = 0u;
+
+  for (auto id = 0; id < size(); ++id)
+  {
+    if (m_owners[id] != Owner::Nobody)
+    {
+      m_hash ^= key(id, m_owners[id]);
+    }
+  }
+
+  m_hash ^= colorKey(Owner::AI, color(Owner::AI));
+  m_hash ^= colorKey(Owner::Player, color(Owner::Player));
+}
+
+auto RegionGraph::colorKey(const Owner &owner, const Color &color) const noexcept -> std::uint64_t
+{
+  return m_topology->colorKeys[colorIndex(owner, color)];
+}
+
+auto RegionGraph::key(int id, const Owner &owner) const noexcept -> std::uint64_t
+{
+  return m_topology->keys[id * static_cast<int>(Owner::Count) + static_cast<int>(owner)];
+}
+
+bool RegionGraph::linked(const std::vector<int> &chain) const noexcept
+{
+  // Look for free regions of the chain, all consecutive, going from the
+  // territory of the player to the one of the AI: the absorbed regions of
+  // the chain split it.
+  const auto player = memberBit(Owner::Player);
+  const auto ai     = memberBit(Owner::AI);
+
+  auto start = false;
+  for (const auto id : chain)
+  {
+    if (m_owners[id] != Owner::Nobody)
+    {
+      start = false;
+      continue;
+    }
+
+    start = start || (m_members[id] & player);
+    if (start && (m_members[id] & ai))
+    {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+bool RegionGraph::registerInFrontier(const Owner &owner, int id)
+{
+  const auto bit = memberBit(owner);
+  if (m_members[id] & bit)
+  {
+    return false;
+  }
+
+  // The outside can't be absorbed: only the owners touching it are kept.
+  if (id == m_topology->outside)
+  {
+    m_members[id] |= bit;
+    return true;
+  }
+
+  const auto &region = m_topology->regions[id];
+  auto &frontier     = m_frontiers[static_cast<int>(owner)];
+
+  if (m_members[id] == 0u)
+  {
+    m_contested += region.size;
+  }
+
+  m_members[id] |= bit;
+  frontier.regions[static_cast<int>(region.color)].push_back(id);
+  frontier.gains[static_cast<int>(region.color)] += region.size;
+
+  return true;
+}
+
+void RegionGraph::unregisterFromFrontier(const Owner &owner, int id)
+{
+  const auto &region = m_topology->regions[id];
+  auto &frontier     = m_frontiers[static_cast<int>(owner)];
+
+  m_members[id] &= ~memberBit(owner);
+  if (id == m_topology->outside)
+  {
+    return;
+  }
+  if (m_members[id] == 0u)
+  {
+    m_contested -= region.size;
+  }
+
+  frontier.regions[static_cast<int>(region.color)].pop_back();
+  frontier.gains[static_cast<int>(region.color)] -= region.size;
+}
+
+} // namespace pge
@@ -0,0 +1,332 @@
+
+#pragma once
+
+#include "Cell.hh"
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace pge {
+
+/// @brief - Describes the board as a graph of regions: a region is a set
+/// of 4-connected free cells with the same color, or a set of 4-connected
+/// cells belonging to the same owner. As the cells of a region are always
+/// absorbed together, the moves can be applied on regions rather than on
+/// cells.
+/// Each owner keeps track of the free regions touching its territory, so
+/// that applying a move only visits the absorbed regions and their direct
+/// neighbors.
+/// The regions and their neighbors never change once the graph is built:
+/// they are shared between the copies of a graph, so that a copy only holds
+/// the state of the game. This is what the AI uses to explore moves.
+/// The state is also summarized by a Zobrist hash updated as regions are
+/// absorbed, so that positions reached through different sequences of
+/// moves can be recognized.
+/// Each move records what it changed so that it can be undone at a cost
+/// proportional to the regions it touched: searches explore moves in place
+/// instead of copying the graph.
+/// A graph may only describe the top left part of a larger board: the
+/// cells which are not described are then gathered in a last region, the
+/// outside, which touches the regions on the right and bottom edges. The
+/// outside can't be absorbed, but it counts in the outcome of the game as
+/// the territory reaching it can reach all of its cells.
+class RegionGraph
+{
+  public:
+  /// @brief - Convenience define to access the cells of a board.
+  using CellAccessor = std::function<Cell(int, int)>;
+
+  /// @brief - A region of the board.
+  struct Region
+  {
+    // The number of cells in the region.
+    int size;
+
+    // The color of the cells of the region. For owned regions this is the
+    // color they had when the graph was built.
+    Color color;
+
+    // The linear index of one of the cells of the region.
+    int seed;
+  };
+
+  /// @brief - Create an empty graph with no regions.
+  RegionGraph() = default;
+
+  /// @brief - Build the graph of the regions of the board described by the
+  /// input accessor. Cells are grouped with a union-find structure, so the
+  /// accessor is called once per cell and once more per region.
+  /// @param width - the width of the board.
+  /// @param height - the height of the board.
+  /// @param cells - a function returning the cell at some coordinates.
+  RegionGraph(int width, int height, const CellAccessor &cells);
+
+  /// @brief - Build the graph of the top left part of a larger board, whose
+  /// other cells are gathered in the outside region.
+  /// @param width - the width of the part described by the accessor.
+  /// @param height - the height of the part described by the accessor.
+  /// @param cells - a function returning the cell at some coordinates.
+  /// @param fullWidth - the width of the whole board.
+  /// @param fullHeight - the height of the whole board.
+  RegionGraph(int width, int height, const CellAccessor &cells, int fullWidth, int fullHeight);
+
+  /// @brief - Returns the number of regions of the graph.
+  /// @return - the number of regions.
+  int size() const noexcept;
+
+  auto region(int id) const noexcept -> const Region &;
+
+  auto owner(int id) const noexcept -> Owner;
+
+  /// @brief - The region gathering the cells of the board which are not
+  /// described by the graph. It is free and has no color: its `color` is
+  /// `Color::Count`.
+  /// @return - the identifier of the region, or `-1` if the graph describes
+  /// the whole board.
+  int outside() const noexcept;
+
+  /// @brief - Whether the next move may reach the cells which are not
+  /// described by the graph: a territory or a free region touching one of
+  /// them touches the outside. The regions touching the outside may be
+  /// larger than what the graph knows of them.
+  /// @return - `true` if a territory or its frontier touches the outside.
+  bool exposed() const noexcept;
+
+  /// @brief - The current color of the territory of an owner. When the graph
+  /// is built, this is the color of the first cell of the territory.
+  /// @param owner - the owner to get the color of.
+  /// @return - the color of the territory.
+  auto color(const Owner &owner) const noexcept -> Color;
+
+  /// @brief - The number of cells owned by an owner, maintained as regions
+  /// are absorbed.
+  /// @param owner - the owner to count the cells of.
+  /// @return - the number of cells of this owner.
+  int count(const Owner &owner) const noexcept;
+
+  /// @brief - The number of free cells in the regions touching at least one
+  /// territory. When it reaches `0`, no cell can be gained anymore.
+  /// @return - the number of cells which can still be gained.
+  int contested() const noexcept;
+
+  /// @brief - The number of cells an owner would gain by picking a color.
+  /// @param owner - the owner picking the color.
+  /// @param color - the color to pick.
+  /// @return - the number of cells of the free regions of this color which
+  /// touch the territory of the owner.
+  int gain(const Owner &owner, const Color &color) const noexcept;
+
+  /// @brief - Whether the territories of the player and the AI touch. As
+  /// territories only grow, this can only become `true`.
+  bool inContact() const noexcept;
+
+  /// @brief - The Zobrist hash of the state of the game: it combines a key
+  /// for each owned region and its owner, and a key for the color of each
+  /// territory. The keys are derived from the fingerprint of the graph, so
+  /// hashes are reproducible from one run to the next while the positions
+  /// of different boards get unrelated hashes.
+  /// @return - the hash of the state.
+  auto hash() const noexcept -> std::uint64_t;
+
+  /// @brief - Identifies the board the graph was built from: it is computed
+  /// from the dimensions of the board and from the regions and neighbors of
+  /// the graph as they were when it was built, and is shared by its copies.
+  /// Results stored for the positions of a board should only be reused for
+  /// graphs with the same fingerprint.
+  /// @return - the fingerprint of the board.
+  auto fingerprint() const noexcept -> std::uint64_t;
+
+  /// @brief - Whether the outcome of the game is decided: no free region can
+  /// be reached by both owners through free regions. Each owner then ends
+  /// up with the free regions it can reach, whatever the moves played.
+  /// The regions reachable from each territory are found with a breadth
+  /// first search from the frontiers of both owners, which stops as soon as
+  /// a region is reached from both sides. The chain of free regions linking
+  /// both territories is then kept: while its regions are still free, the
+  /// following calls answer without searching. The buffers of the search
+  /// are reused from one call to the next, so calls on the same graph
+  /// should not run concurrently.
+  /// @param finals - output number of cells of each owner at the end of the
+  /// game, only set when the outcome is decided.
+  /// @return - `true` if the outcome of the game is decided.
+  bool decided(std::array<int, static_cast<int>(Owner::Count)> &finals) const;
+
+  /// @brief - The number of calls to `decided` which had to search the
+  /// regions of this graph rather than answering from the chain they kept.
+  /// Each search visits up to all the regions of the board, which matters
+  /// to callers bounding the time they spend.
+  /// @return - the number of searches run so far.
+  int searches() const noexcept;
+
+  /// @brief - Whether an owner is allowed to pick a color: it can't pick its
+  /// current color, nor the color of the other owner when their territories
+  /// are in contact.
+  /// @param owner - the owner picking the color.
+  /// @param color - the color to pick.
+  /// @return - `true` if the color can be picked.
+  bool canPick(const Owner &owner, const Color &color) const noexcept;
+
+  /// @brief - The color an owner picks when it plays greedily: the one
+  /// bringing the most cells among the colors it can pick, the first one in
+  /// the order of the colors in case of a tie. When no color brings any
+  /// cell, the color is drawn from the fingerprint of the graph and the
+  /// number of moves, so that the games played on a board are reproducible.
+  /// @param owner - the owner picking the color.
+  /// @return - the color to pick.
+  auto bestColor(const Owner &owner) const noexcept -> Color;
+
+  /// @brief - Changes the color of the territory of the owner, which gains
+  /// all the free regions of this color touching it.
+  /// @param owner - the owner picking the color.
+  /// @param color - the color picked.
+  /// @param absorbed - output list where the identifiers of the regions which
+  /// were absorbed are appended.
+  void absorb(const Owner &owner, const Color &color, std::vector<int> &absorbed);
+
+  /// @brief - The number of moves which can be undone.
+  /// @return - the number of moves applied since the graph was built.
+  int history() const noexcept;
+
+  /// @brief - Reverts the last move applied with `absorb`, restoring the
+  /// graph in the exact state it had before. Nothing happens if there is
+  /// no move to undo.
+  /// @param released - output list where the identifiers of the regions
+  /// which are free again are appended.
+  /// @return - the owner whose move was reverted, or `Nobody` if there was
+  /// no move to undo.
+  auto undo(std::vector<int> &released) -> Owner;
+
+  private:
+  /// @brief - The free regions touching the territory of an owner, bucketed
+  /// by color.
+  struct Frontier
+  {
+    // The regions in each bucket. Regions absorbed by the other owner are
+    // not removed right away: they are skipped when the bucket is consumed.
+    std::array<std::vector<int>, static_cast<int>(Color::Count)> regions{};
+
+    // The number of cells of the regions of each bucket which are still
+    // free.
+    std::array<int, static_cast<int>(Color::Count)> gains{};
+  };
+
+  /// @brief - What a move changed in the graph, to be able to undo it.
+  struct Change
+  {
+    Owner owner;
+
+    // The color of the territory of the owner before the move.
+    Color previous;
+
+    // The color picked.
+    Color color;
+
+    bool inContact;
+
+    // The gain of the bucket of the picked color before the move.
+    int gain;
+
+    // The journal of the move starts at this offset in `m_journal` with the
+    // content of the bucket of the picked color, which has `bucket` regions.
+    int start;
+    int bucket;
+  };
+
+  /// @brief - The part of the graph which does not change during a game.
+  struct Topology
+  {
+    std::vector<Region> regions{};
+
+    // The neighbors of region `i` are stored in the range defined by
+    // `offsets[i]` and `offsets[i + 1]` of `neighbors`.
+    std::vector<int> offsets{};
+    std::vector<int> neighbors{};
+
+    // Identifies the board the graph was built from.
+    std::uint64_t fingerprint{0u};
+
+    // The region gathering the cells which are not described, if any.
+    int outside{-1};
+
+    // The Zobrist key of each region for each owner, stored at index
+    // `region * Owner::Count + owner`.
+    std::vector<std::uint64_t> keys{};
+
+    // The Zobrist key of each color for each owner, stored at index
+    // `owner * Color::Count + color`.
+    std::array<std::uint64_t, static_cast<int>(Owner::Count) * static_cast<int>(Color::Count)>
+      colorKeys{};
+  };
+
+  std::shared_ptr<const Topology> m_topology{std::make_shared<Topology>()};
+
+  /// @brief - The owner of each region.
+  std::vector<Owner> m_owners{};
+
+  /// @brief - For each region, a bit per owner indicating whether it was
+  /// registered in the frontier of this owner. The outside gets the bits of
+  /// the owners touching it, but is never added to their buckets.
+  std::vector<std::uint8_t> m_members{};
+
+  std::array<Frontier, static_cast<int>(Owner::Count)> m_frontiers{};
+
+  bool m_inContact{false};
+
+  /// @brief - The color of the territory of each owner.
+  std::array<Color, static_cast<int>(Owner::Count)> m_colors{};
+
+  /// @brief - The number of cells of each owner.
+  std::array<int, static_cast<int>(Owner::Count)> m_counts{};
+
+  /// @brief - The number of free cells in regions registered in at least
+  /// one frontier.
+  int m_contested{0};
+
+  std::uint64_t m_hash{0u};
+
+  /// @brief - Free regions linking the territories of both owners, found by
+  /// the last search of `decided`: each region touches the next one, the
+  /// first one touches the territory of the player and the last one the
+  /// territory of the AI.
+  mutable std::vector<int> m_witness{};
+
+  /// @brief - Buffers reused by the searches of `decided`: the owners which
+  /// reached each region and the region it was reached from.
+  mutable std::vector<std::uint8_t> m_reached{};
+  mutable std::vector<int> m_parents{};
+  mutable std::vector<int> m_pending{};
+  mutable int m_searches{0};
+
+  /// @brief - The moves applied since the graph was built.
+  std::vector<Change> m_changes{};
+
+  /// @brief - For each move, the content of the bucket of the picked color
+  /// followed by the regions in the order they were modified: a region
+  /// registered in the frontier of the owner is stored as is, while an
+  /// absorbed region `id` is stored as `-id - 1`.
+  std::vector<int> m_journal{};
+
+  void buildRegions(int width,
+                    int height,
+                    const CellAccessor &cells,
+                    int fullWidth,
+                    int fullHeight);
+  void buildNeighbors(int width,
+                      int height,
+                      const std::vector<int> &labels,
+                      bool right,
+                      bool bottom,
+                      Topology &topology) const;
+  void buildKeys(int width, int height, Topology &topology) const;
+  void buildFrontiers();
+  void buildHash();
+  auto key(int id, const Owner &owner) const noexcept -> std::uint64_t;
+  auto colorKey(const Owner &owner, const Color &color) const noexcept -> std::uint64_t;
+  bool linked(const std::vector<int> &chain) const noexcept;
+  bool registerInFrontier(const Owner &owner, int id);
+  void unregisterFromFrontier(const Owner &owner, int id);
+};
+
+} // namespace pge
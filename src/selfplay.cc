@@ -0,0 +1,397 @@
+
+/// @brief - Plays games between two AI engines without any window, to
+/// measure the strength of the engines and the speed of the search.
+
+#include "AlphaBetaEngine.hh"
+#include "Board.hh"
+#include "ExhaustiveEngine.hh"
+#include "GreedyEngine.hh"
+#include "MctsEngine.hh"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <core_utils/CoreException.hh>
+#include <core_utils/log/Locator.hh>
+#include <core_utils/log/PrefixedLogger.hh>
+#include <core_utils/log/StdLogger.hh>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+/// @brief - The number of bits used to index the table of the exhaustive
+/// engine of each thread, smaller than the default one as many threads run
+/// at once.
+constexpr auto SELFPLAY_EXHAUSTIVE_TABLE_BITS = 18;
+
+/// @brief - The settings of a tournament.
+struct Options
+{
+  int size{32};
+  int games{100};
+
+  // Chunked boards only generate the cells reached by the territories, so
+  // that very large boards can be played.
+  pge::Generation generation{pge::Generation::Eager};
+
+  std::uint64_t seed{0u};
+  int threads{static_cast<int>(std::max(1u, std::thread::hardware_concurrency()))};
+
+  // The time allowed to the engines for each move, in milliseconds.
+  int budget{pge::ai::DEFAULT_TIME_BUDGET_MS};
+
+  // The engines playing against each other. The first one plays as the
+  // player in even games, and as the AI in odd games.
+  pge::ai::Kind first{pge::ai::Kind::Greedy};
+  pge::ai::Kind second{pge::ai::Kind::AlphaBeta};
+};
+
+/// @brief - The results gathered by a thread.
+struct Stats
+{
+  int games{0};
+  int moves{0};
+
+  // The number of cells generated for the boards of the games, which is
+  // less than their size for chunked boards.
+  long cells{0};
+
+  // The number of games won by each engine, and the number of draws.
+  std::array<int, 2> wins{};
+  int draws{0};
+
+  // The time taken by each move of each engine, in nanoseconds.
+  std::array<std::vector<long>, 2> latencies{};
+};
+
+void usage(const char *name)
+{
+  std::printf("Usage: %s [options]\n", name);
+  std::printf("  --size N      width and height of the boards (default 32)\n");
+  std::printf("  --chunks 0|1  generate the boards by chunks as they are reached (default 0)\n");
+  std::printf("  --games N     number of games to play (default 100)\n");
+  std::printf("  --seed N      seed of the first board, incremented for each game (default 0)\n");
+  std::printf("  --threads N   number of games played at once (default: one per core)\n");
+  std::printf("  --budget MS   time allowed for each move of the engines (default %d)\n",
+              pge::ai::DEFAULT_TIME_BUDGET_MS);
+  std::printf("  --first KIND  first engine (default greedy)\n");
+  std::printf("  --second KIND second engine (default alpha-beta)\n");
+  std::printf("Engines: greedy, alpha-beta, mcts, exhaustive\n");
+}
+
+bool parseKind(const std::string &name, pge::ai::Kind &kind)
+{
+  for (const auto k : {pge::ai::Kind::Greedy,
+                       pge::ai::Kind::AlphaBeta,
+                       pge::ai::Kind::Mcts,
+                       pge::ai::Kind::Exhaustive})
+  {
+    if (pge::ai::kindName(k) == name)
+    {
+      kind = k;
+      return true;
+    }
+  }
+
+  return false;
+}
+
+bool parseOptions(int argc, char **argv, Options &options)
+{
+  for (auto id = 1; id < argc; ++id)
+  {
+    const std::string arg(argv[id]);
+    if (id + 1 >= argc)
+    {
+      return false;
+    }
+
+    const std::string value(argv[++id]);
+    try
+    {
+      if (arg == "--size")
+      {
+        options.size = std::stoi(value);
+      }
+      else if (arg == "--chunks")
+      {
+        options.generation = (std::stoi(value) != 0 ? pge::Generation::Chunked
+                                                     : pge::Generation::Eager);
+      }
+      else if (arg == "--games")
+      {
+        options.games = std::stoi(value);
+      }
+      else if (arg == "--seed")
+      {
+        options.seed = std::stoull(value);
+      }
+      else if (arg == "--threads")
+      {
+        options.threads = std::stoi(value);
+      }
+      else if (arg == "--budget")
+      {
+        options.budget = std::stoi(value);
+      }
+      else if (arg == "--first")
+      {
+        if (!parseKind(value, options.first))
+        {
+          return false;
+        }
+      }
+      else if (arg == "--second")
+      {
+        if (!parseKind(value, options.second))
+        {
+          return false;
+        }
+      }
+      else
+      {
+        return false;
+      }
+    }
+    catch (const std::exception &)
+    {
+      return false;
+    }
+  }
+
+  return options.size >= 4 && options.games > 0 && options.threads > 0 && options.budget > 0;
+}
+
+/// @brief - Creates an engine searching on the calling thread only: the
+/// games are already played in parallel.
+auto newSelfPlayEngine(const pge::ai::Kind &kind, int budget) -> pge::ai::EngineShPtr
+{
+  switch (kind)
+  {
+    case pge::ai::Kind::AlphaBeta:
+      return std::make_shared<pge::ai::AlphaBetaEngine>(pge::ai::MAX_SEARCH_DEPTH, nullptr, budget);
+    case pge::ai::Kind::Mcts:
+      return std::make_shared<pge::ai::MctsEngine>(budget, nullptr);
+    case pge::ai::Kind::Exhaustive:
+      return std::make_shared<pge::ai::ExhaustiveEngine>(
+        nullptr,
+        SELFPLAY_EXHAUSTIVE_TABLE_BITS,
+        std::make_shared<pge::ai::AlphaBetaEngine>(pge::ai::MAX_SEARCH_DEPTH, nullptr, budget),
+        budget);
+    case pge::ai::Kind::Greedy:
+    default:
+      return std::make_shared<pge::ai::GreedyEngine>();
+  }
+}
+
+/// @brief - Plays a single game on a board generated from a seed, as the
+/// application does, and updates the statistics with it.
+/// @param flipped - whether the first engine plays as the AI.
+void playGame(const Options &options,
+              std::uint64_t seed,
+              const std::array<pge::ai::EngineShPtr, 2> &engines,
+              bool flipped,
+              Stats &stats)
+{
+  pge::Board board(options.size, options.size, seed, options.generation);
+  const auto &graph = board.regions();
+  const auto cells  = options.size * options.size;
+
+  std::array<int, static_cast<int>(pge::Owner::Count)> finals{};
+
+  // Engines picking colors bringing no cell could play forever: games
+  // are stopped after a number of moves large enough to fill the board.
+  auto owner = pge::Owner::Player;
+  auto move  = 0;
+  for (; move < 4 * cells && !graph.decided(finals); ++move)
+  {
+    const auto id = (owner == pge::Owner::Player) == flipped ? 1 : 0;
+
+    const auto start = Clock::now();
+    const auto res   = engines[id]->search(graph, owner);
+    const auto end   = Clock::now();
+
+    stats.latencies[id].push_back(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+    ++stats.moves;
+
+    board.changeColorOf(owner, res.color);
+    owner = pge::opponentOf(owner);
+  }
+
+  if (move == 4 * cells)
+  {
+    finals[static_cast<int>(pge::Owner::Player)] = graph.count(pge::Owner::Player);
+    finals[static_cast<int>(pge::Owner::AI)]     = graph.count(pge::Owner::AI);
+  }
+
+  const auto player = finals[static_cast<int>(pge::Owner::Player)];
+  const auto ai     = finals[static_cast<int>(pge::Owner::AI)];
+
+  ++stats.games;
+  stats.cells += static_cast<long>(board.width()) * board.height();
+  if (player == ai)
+  {
+    ++stats.draws;
+  }
+  else
+  {
+    const auto playerWins = player > ai;
+    ++stats.wins[playerWins == flipped ? 1 : 0];
+  }
+}
+
+/// @brief - The value below which a ratio of the sorted input values fall,
+/// converted from nanoseconds to microseconds.
+auto percentile(const std::vector<long> &sorted, double ratio) -> double
+{
+  if (sorted.empty())
+  {
+    return 0.0;
+  }
+
+  const auto id = static_cast<std::size_t>(ratio * (sorted.size() - 1));
+  return sorted[id] / 1000.0;
+}
+
+void report(const Options &options, const Stats &stats, double seconds)
+{
+  std::printf("%d game(s) on %dx%d boards with %d thread(s) in %.2fs\n",
+              stats.games,
+              options.size,
+              options.size,
+              options.threads,
+              seconds);
+  std::printf("games/s: %.2f, moves/s: %.2f\n", stats.games / seconds, stats.moves / seconds);
+  std::printf("cells generated per game: %.0f (%.1f%% of the board)\n",
+              1.0 * stats.cells / stats.games,
+              100.0 * stats.cells / stats.games / options.size / options.size);
+
+  const std::array<pge::ai::Kind, 2> kinds{options.first, options.second};
+  for (auto id = 0; id < 2; ++id)
+  {
+    auto sorted = stats.latencies[id];
+    std::sort(sorted.begin(), sorted.end());
+
+    std::printf("%-10s win rate: %5.1f%%, "
+                "latency (us) p50: %.1f, p90: %.1f, p99: %.1f, max: %.1f\n",
+                pge::ai::kindName(kinds[id]).c_str(),
+                100.0 * stats.wins[id] / stats.games,
+                percentile(sorted, 0.5),
+                percentile(sorted, 0.9),
+                percentile(sorted, 0.99),
+                percentile(sorted, 1.0));
+  }
+
+  std::printf("draws: %5.1f%%\n", 100.0 * stats.draws / stats.games);
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+  utils::log::StdLogger raw;
+  raw.setLevel(utils::log::Severity::INFO);
+  utils::log::PrefixedLogger logger("pge", "selfplay");
+  utils::log::Locator::provide(&raw);
+
+  Options options;
+  if (!parseOptions(argc, argv, options))
+  {
+    usage(argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  try
+  {
+    std::vector<Stats> stats(options.threads);
+    std::atomic<int> next(0);
+
+    // The first error raised by a worker, thrown again once all of them
+    // are done. The other workers stop picking games when it is set.
+    std::exception_ptr failure;
+    std::mutex locker;
+
+    const auto start = Clock::now();
+
+    std::vector<std::thread> workers;
+    for (auto id = 0; id < options.threads; ++id)
+    {
+      workers.emplace_back([&options, &next, &failure, &locker, &out = stats[id]]() {
+        try
+        {
+          const std::array<pge::ai::EngineShPtr, 2> engines{
+            newSelfPlayEngine(options.first, options.budget),
+            newSelfPlayEngine(options.second, options.budget),
+          };
+
+          for (auto game = next++; game < options.games; game = next++)
+          {
+            playGame(options, options.seed + game, engines, game % 2 == 1, out);
+          }
+        }
+        catch (...)
+        {
+          next = options.games;
+
+          const std::lock_guard<std::mutex> guard(locker);
+          if (failure == nullptr)
+          {
+            failure = std::current_exception();
+          }
+        }
+      });
+    }
+
+    for (auto &worker : workers)
+    {
+      worker.join();
+    }
+
+    if (failure != nullptr)
+    {
+      std::rethrow_exception(failure);
+    }
+
+    const auto seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    Stats total;
+    for (const auto &s : stats)
+    {
+      total.games += s.games;
+      total.moves += s.moves;
+      total.cells += s.cells;
+      total.draws += s.draws;
+      for (auto id = 0; id < 2; ++id)
+      {
+        total.wins[id] += s.wins[id];
+        total.latencies[id].insert(total.latencies[id].end(),
+                                   s.latencies[id].begin(),
+                                   s.latencies[id].end());
+      }
+    }
+
+    report(options, total, seconds);
+  }
+  catch (const utils::CoreException &e)
+  {
+    logger.error("Caught internal exception while playing games", e.what());
+    return EXIT_FAILURE;
+  }
+  catch (const std::exception &e)
+  {
+    logger.error("Caught internal exception while playing games", e.what());
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
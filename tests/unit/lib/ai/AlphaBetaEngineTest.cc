@@ -0,0 +1,166 @@
+
+#include "AlphaBetaEngine.hh"
+#include <chrono>
+#include <gtest/gtest.h>
+#include <random>
+
+using namespace ::testing;
+
+namespace pge::ai {
+namespace {
+
+constexpr auto SIZE = 5;
+
+auto generateGraph(std::mt19937 &rng, int size = SIZE) -> RegionGraph
+{
+  std::uniform_int_distribution<int> colors(0, static_cast<int>(Color::Count) - 1);
+
+  std::vector<Cell> cells(size * size);
+  for (auto &cell : cells)
+  {
+    cell = Cell{Owner::Nobody, static_cast<Color>(colors(rng))};
+  }
+  cells.front().owner = Owner::Player;
+  cells.back().owner  = Owner::AI;
+
+  return RegionGraph(size, size, [&cells, size](const int x, const int y) {
+    return cells[y * size + x];
+  });
+}
+
+/// @brief - Reference search exploring all the moves without pruning.
+int minimax(const RegionGraph &graph, const Owner &owner, int depth)
+{
+  if (depth == 0 || graph.contested() == 0)
+  {
+    return evaluate(graph, owner);
+  }
+
+  Moves moves;
+  const auto count = generateMoves(graph, owner, moves);
+
+  auto best = std::numeric_limits<int>::min();
+  for (auto id = 0; id < count; ++id)
+  {
+    auto child = graph;
+    std::vector<int> absorbed;
+    child.absorb(owner, moves[id].color, absorbed);
+
+    best = std::max(best, -minimax(child, opponentOf(owner), depth - 1));
+  }
+
+  return best;
+}
+
+} // namespace
+
+TEST(Unit_Search, GenerateMoves)
+{
+  std::mt19937 rng(12);
+  const auto graph = generateGraph(rng);
+
+  Moves moves;
+  const auto count = generateMoves(graph, Owner::Player, moves);
+
+  ASSERT_GT(count, 0);
+  EXPECT_EQ(moves[0].color, graph.bestColor(Owner::Player));
+  for (auto id = 0; id < count; ++id)
+  {
+    EXPECT_TRUE(graph.canPick(Owner::Player, moves[id].color));
+    EXPECT_EQ(moves[id].gain, graph.gain(Owner::Player, moves[id].color));
+    EXPECT_GT(moves[id].gain, 0);
+    if (id > 0)
+    {
+      EXPECT_GE(moves[id - 1].gain, moves[id].gain);
+    }
+  }
+}
+
+TEST(Unit_AlphaBetaEngine, MatchesMinimax)
+{
+  std::mt19937 rng(42);
+
+  for (auto game = 0; game < 20; ++game)
+  {
+    const auto graph = generateGraph(rng);
+
+    for (auto depth = 1; depth <= 4; ++depth)
+    {
+      AlphaBetaEngine engine(depth);
+      const auto res = engine.search(graph, Owner::Player);
+
+      EXPECT_EQ(res.score, minimax(graph, Owner::Player, depth));
+      EXPECT_GT(res.nodes, 0);
+    }
+  }
+}
+
+TEST(Unit_AlphaBetaEngine, ParallelMatchesMinimax)
+{
+  std::mt19937 rng(43);
+  auto pool = std::make_shared<ThreadPool>(4);
+
+  for (auto game = 0; game < 20; ++game)
+  {
+    const auto graph = generateGraph(rng);
+
+    AlphaBetaEngine engine(4, pool);
+    const auto res = engine.search(graph, Owner::AI);
+
+    EXPECT_EQ(res.score, minimax(graph, Owner::AI, 4));
+
+    auto child = graph;
+    std::vector<int> absorbed;
+    child.absorb(Owner::AI, res.color, absorbed);
+    EXPECT_EQ(res.score, -minimax(child, Owner::Player, 3));
+  }
+}
+
+TEST(Unit_AlphaBetaEngine, PicksScoredMove)
+{
+  std::mt19937 rng(7);
+  const auto graph = generateGraph(rng);
+
+  AlphaBetaEngine engine(3);
+  const auto res = engine.search(graph, Owner::AI);
+
+  auto child = graph;
+  std::vector<int> absorbed;
+  child.absorb(Owner::AI, res.color, absorbed);
+
+  EXPECT_EQ(res.score, -minimax(child, Owner::Player, 2));
+}
+
+TEST(Unit_AlphaBetaEngine, StopsAtEndOfGame)
+{
+  std::mt19937 rng(8);
+  const auto graph = generateGraph(rng, 4);
+
+  AlphaBetaEngine engine(MAX_SEARCH_DEPTH);
+  const auto res = engine.search(graph, Owner::Player);
+
+  EXPECT_GT(res.depth, 0);
+  EXPECT_LT(res.depth, MAX_SEARCH_DEPTH);
+  EXPECT_EQ(res.score, minimax(graph, Owner::Player, res.depth));
+}
+
+TEST(Unit_AlphaBetaEngine, MeetsDeadline)
+{
+  std::mt19937 rng(9);
+  const auto graph = generateGraph(rng, 48);
+
+  constexpr auto BUDGET_MS = 30;
+  AlphaBetaEngine engine(MAX_SEARCH_DEPTH, nullptr, BUDGET_MS);
+
+  const auto start = std::chrono::steady_clock::now();
+  const auto res   = engine.search(graph, Owner::Player);
+  const auto end   = std::chrono::steady_clock::now();
+
+  EXPECT_TRUE(graph.canPick(Owner::Player, res.color));
+  EXPECT_GT(res.depth, 0);
+  EXPECT_LT(res.depth, MAX_SEARCH_DEPTH);
+  EXPECT_LT(std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count(),
+            BUDGET_MS + 20);
+}
+
+} // namespace pge::ai
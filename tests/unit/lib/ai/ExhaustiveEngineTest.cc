@@ -0,0 +1,127 @@
+
+#include "AlphaBetaEngine.hh"
+#include "ExhaustiveEngine.hh"
+#include "GreedyEngine.hh"
+#include <chrono>
+#include <gtest/gtest.h>
+#include <random>
+
+using namespace ::testing;
+
+namespace pge::ai {
+namespace {
+
+auto generateGraph(std::mt19937 &rng, int size) -> RegionGraph
+{
+  std::uniform_int_distribution<int> colors(0, static_cast<int>(Color::Count) - 1);
+
+  std::vector<Cell> cells(size * size);
+  for (auto &cell : cells)
+  {
+    cell = Cell{Owner::Nobody, static_cast<Color>(colors(rng))};
+  }
+  cells.front().owner = Owner::Player;
+  cells.back().owner  = Owner::AI;
+
+  return RegionGraph(size, size, [&cells, size](const int x, const int y) {
+    return cells[y * size + x];
+  });
+}
+
+} // namespace
+
+TEST(Unit_ExhaustiveEngine, MatchesFullDepthSearch)
+{
+  std::mt19937 rng(21);
+
+  for (auto game = 0; game < 10; ++game)
+  {
+    const auto graph = generateGraph(rng, 4);
+
+    ExhaustiveEngine engine(nullptr, 12);
+    AlphaBetaEngine reference(MAX_SEARCH_DEPTH);
+
+    EXPECT_EQ(engine.search(graph, Owner::Player).score,
+              reference.search(graph, Owner::Player).score);
+  }
+}
+
+TEST(Unit_ExhaustiveEngine, KeepsScoreAfterBestMove)
+{
+  std::mt19937 rng(22);
+  auto pool = std::make_shared<ThreadPool>(4);
+
+  for (auto game = 0; game < 5; ++game)
+  {
+    const auto graph = generateGraph(rng, 5);
+
+    ExhaustiveEngine serial(nullptr, 16);
+    ExhaustiveEngine parallel(pool, 16);
+
+    const auto res = serial.search(graph, Owner::AI);
+    EXPECT_EQ(parallel.search(graph, Owner::AI).score, res.score);
+
+    // The score is kept by the best reply of the opponent.
+    auto child = graph;
+    std::vector<int> absorbed;
+    child.absorb(Owner::AI, res.color, absorbed);
+    EXPECT_EQ(serial.search(child, Owner::Player).score, -res.score);
+  }
+}
+
+TEST(Unit_ExhaustiveEngine, ReusedAcrossBoards)
+{
+  std::mt19937 rng(25);
+  ExhaustiveEngine reused(nullptr, 12);
+
+  // The positions of a board are never used for another one.
+  for (auto game = 0; game < 20; ++game)
+  {
+    const auto graph = generateGraph(rng, 4);
+
+    ExhaustiveEngine fresh(nullptr, 12);
+    EXPECT_EQ(reused.search(graph, Owner::AI).score, fresh.search(graph, Owner::AI).score);
+  }
+}
+
+TEST(Unit_ExhaustiveEngine, LargeBoardsUseFallback)
+{
+  std::mt19937 rng(24);
+  const auto graph = generateGraph(rng, 16);
+
+  ExhaustiveEngine engine(nullptr, 4, std::make_shared<GreedyEngine>());
+  GreedyEngine greedy;
+
+  const auto res = engine.search(graph, Owner::Player);
+  const auto ref = greedy.search(graph, Owner::Player);
+  EXPECT_EQ(res.color, ref.color);
+  EXPECT_EQ(res.score, ref.score);
+  EXPECT_TRUE(engine.delegated());
+
+  // Small boards are searched by the engine itself.
+  engine.search(generateGraph(rng, 4), Owner::Player);
+  EXPECT_FALSE(engine.delegated());
+}
+
+TEST(Unit_ExhaustiveEngine, MeetsDeadline)
+{
+  // A board small enough to be searched, but which takes much longer than
+  // the budget.
+  std::mt19937 rng(26);
+  const auto graph = generateGraph(rng, 8);
+
+  constexpr auto BUDGET_MS = 30;
+  ExhaustiveEngine engine(nullptr, 16, std::make_shared<GreedyEngine>(), BUDGET_MS);
+  GreedyEngine greedy;
+
+  const auto start = std::chrono::steady_clock::now();
+  const auto res   = engine.search(graph, Owner::Player);
+  const auto end   = std::chrono::steady_clock::now();
+
+  EXPECT_TRUE(engine.delegated());
+  EXPECT_EQ(res.color, greedy.search(graph, Owner::Player).color);
+  EXPECT_LT(std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count(),
+            BUDGET_MS + 20);
+}
+
+} // namespace pge::ai
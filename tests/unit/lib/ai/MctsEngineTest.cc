@@ -0,0 +1,76 @@
+
+#include "MctsEngine.hh"
+#include <gtest/gtest.h>
+
+using namespace ::testing;
+
+namespace pge::ai {
+namespace {
+
+constexpr auto P = Cell{Owner::Player, Color::Yellow};
+constexpr auto A = Cell{Owner::AI, Color::Cyan};
+constexpr auto R = Cell{Owner::Nobody, Color::Red};
+constexpr auto G = Cell{Owner::Nobody, Color::Green};
+constexpr auto B = Cell{Owner::Nobody, Color::Blue};
+
+constexpr auto WIDTH  = 6;
+constexpr auto HEIGHT = 2;
+
+// The player only wins by picking red: otherwise the AI takes the red
+// cells through the top right corner.
+// clang-format off
+const std::vector<Cell> CELLS = {
+  P, R, R, R, R, R,
+  G, B, B, B, B, A,
+};
+// clang-format on
+
+auto generateGraph() -> RegionGraph
+{
+  return RegionGraph(WIDTH, HEIGHT, [](const int x, const int y) {
+    return CELLS[y * WIDTH + x];
+  });
+}
+
+} // namespace
+
+TEST(Unit_MctsEngine, PicksWinningMove)
+{
+  const auto graph = generateGraph();
+
+  MctsEngine engine(50);
+  const auto res = engine.search(graph, Owner::Player);
+
+  EXPECT_EQ(res.color, Color::Red);
+  EXPECT_GT(res.nodes, 0);
+  EXPECT_EQ(res.score, 100);
+}
+
+TEST(Unit_MctsEngine, ParallelPicksWinningMove)
+{
+  const auto graph = generateGraph();
+
+  MctsEngine engine(50, std::make_shared<ThreadPool>(4));
+  const auto res = engine.search(graph, Owner::Player);
+
+  EXPECT_EQ(res.color, Color::Red);
+  EXPECT_GT(res.nodes, 0);
+}
+
+TEST(Unit_MctsEngine, SingleMove)
+{
+  auto graph = generateGraph();
+
+  std::vector<int> absorbed;
+  graph.absorb(Owner::Player, Color::Red, absorbed);
+  graph.absorb(Owner::AI, Color::Blue, absorbed);
+
+  // Only green brings cells: there is nothing to search.
+  MctsEngine engine(50);
+  const auto res = engine.search(graph, Owner::Player);
+
+  EXPECT_EQ(res.color, Color::Green);
+  EXPECT_EQ(res.nodes, 0);
+}
+
+} // namespace pge::ai
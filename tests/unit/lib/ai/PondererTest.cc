@@ -0,0 +1,114 @@
+
+#include "GreedyEngine.hh"
+#include "Ponderer.hh"
+#include <gtest/gtest.h>
+#include <random>
+#include <thread>
+
+using namespace ::testing;
+
+namespace pge::ai {
+namespace {
+
+constexpr auto SIZE = 6;
+
+auto generateGraph() -> RegionGraph
+{
+  std::mt19937 rng(5);
+  std::uniform_int_distribution<int> colors(0, static_cast<int>(Color::Count) - 1);
+
+  std::vector<Cell> cells(SIZE * SIZE);
+  for (auto &cell : cells)
+  {
+    cell = Cell{Owner::Nobody, static_cast<Color>(colors(rng))};
+  }
+  cells.front().owner = Owner::Player;
+  cells.back().owner  = Owner::AI;
+
+  return RegionGraph(SIZE, SIZE, [&cells](const int x, const int y) {
+    return cells[y * SIZE + x];
+  });
+}
+
+/// @brief - Waits for the reply to a position to be available.
+bool waitForReply(const Ponderer &ponderer, std::uint64_t hash, Color &color)
+{
+  for (auto attempt = 0; attempt < 500; ++attempt)
+  {
+    if (ponderer.reply(hash, color))
+    {
+      return true;
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+
+  return false;
+}
+
+} // namespace
+
+TEST(Unit_Ponderer, RepliesToAllMoves)
+{
+  const auto graph = generateGraph();
+  auto engine      = std::make_shared<GreedyEngine>();
+
+  Ponderer ponderer(engine);
+  ponderer.start(graph, Owner::AI);
+
+  for (auto cId = 0; cId < static_cast<int>(Color::Count); ++cId)
+  {
+    const auto color = static_cast<Color>(cId);
+    if (!graph.canPick(Owner::Player, color))
+    {
+      continue;
+    }
+
+    auto child = graph;
+    std::vector<int> absorbed;
+    child.absorb(Owner::Player, color, absorbed);
+
+    Color reply;
+    ASSERT_TRUE(waitForReply(ponderer, child.hash(), reply));
+    EXPECT_EQ(reply, engine->search(child, Owner::AI).color);
+  }
+
+  // The replies are kept once pondering stops.
+  ponderer.stop();
+
+  auto child = graph;
+  std::vector<int> absorbed;
+  Moves moves;
+  generateMoves(graph, Owner::Player, moves);
+  child.absorb(Owner::Player, moves[0].color, absorbed);
+
+  Color reply;
+  EXPECT_TRUE(ponderer.reply(child.hash(), reply));
+}
+
+TEST(Unit_Ponderer, ForgetsPreviousPosition)
+{
+  auto graph  = generateGraph();
+  auto engine = std::make_shared<GreedyEngine>();
+
+  Ponderer ponderer(engine);
+  ponderer.start(graph, Owner::AI);
+
+  Moves moves;
+  generateMoves(graph, Owner::Player, moves);
+
+  std::vector<int> absorbed;
+  graph.absorb(Owner::Player, moves[0].color, absorbed);
+  const auto hash = graph.hash();
+
+  Color reply;
+  ASSERT_TRUE(waitForReply(ponderer, hash, reply));
+
+  graph.absorb(Owner::AI, reply, absorbed);
+  ponderer.start(graph, Owner::AI);
+  ponderer.stop();
+
+  EXPECT_FALSE(ponderer.reply(hash, reply));
+}
+
+} // namespace pge::ai
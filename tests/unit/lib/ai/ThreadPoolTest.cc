@@ -0,0 +1,50 @@
+
+#include "ThreadPool.hh"
+#include <atomic>
+#include <gtest/gtest.h>
+
+using namespace ::testing;
+
+namespace pge::ai {
+
+TEST(Unit_ThreadPool, Size)
+{
+  ThreadPool pool(3);
+  EXPECT_EQ(pool.size(), 3);
+
+  ThreadPool single(0);
+  EXPECT_EQ(single.size(), 1);
+}
+
+TEST(Unit_ThreadPool, Submit)
+{
+  ThreadPool pool(4);
+
+  std::vector<std::future<int>> futures;
+  for (auto id = 0; id < 100; ++id)
+  {
+    futures.push_back(pool.submit([id]() { return id * id; }));
+  }
+
+  for (auto id = 0; id < 100; ++id)
+  {
+    EXPECT_EQ(futures[id].get(), id * id);
+  }
+}
+
+TEST(Unit_ThreadPool, RunsPendingTasksBeforeStopping)
+{
+  std::atomic<int> count(0);
+
+  {
+    ThreadPool pool(2);
+    for (auto id = 0; id < 50; ++id)
+    {
+      pool.submit([&count]() { ++count; });
+    }
+  }
+
+  EXPECT_EQ(count.load(), 50);
+}
+
+} // namespace pge::ai
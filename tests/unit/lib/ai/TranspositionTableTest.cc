@@ -0,0 +1,72 @@
+
+#include "TranspositionTable.hh"
+#include <gtest/gtest.h>
+
+using namespace ::testing;
+
+namespace pge::ai {
+
+TEST(Unit_TranspositionTable, Constructor)
+{
+  TranspositionTable table(4);
+  EXPECT_EQ(table.size(), 16);
+
+  TableEntry entry;
+  EXPECT_FALSE(table.probe(0u, entry));
+  EXPECT_FALSE(table.probe(12u, entry));
+}
+
+TEST(Unit_TranspositionTable, StoreAndProbe)
+{
+  TranspositionTable table(4);
+  table.store(0x1234u, TableEntry{-17, 3, Bound::Upper, Color::Magenta});
+
+  TableEntry entry{};
+  ASSERT_TRUE(table.probe(0x1234u, entry));
+  EXPECT_EQ(entry.score, -17);
+  EXPECT_EQ(entry.depth, 3);
+  EXPECT_EQ(entry.bound, Bound::Upper);
+  EXPECT_EQ(entry.move, Color::Magenta);
+
+  // Same slot but a different position.
+  EXPECT_FALSE(table.probe(0x1244u, entry));
+
+  table.clear();
+  EXPECT_FALSE(table.probe(0x1234u, entry));
+}
+
+TEST(Unit_TranspositionTable, Replacement)
+{
+  TranspositionTable table(4);
+  table.store(0x1234u, TableEntry{5, 4, Bound::Exact, Color::Red});
+
+  // A shallower search of the same position keeps the deeper entry.
+  TableEntry entry{};
+  table.store(0x1234u, TableEntry{2, 2, Bound::Lower, Color::Green});
+  ASSERT_TRUE(table.probe(0x1234u, entry));
+  EXPECT_EQ(entry.score, 5);
+
+  // Another position always replaces the entry.
+  table.store(0x1244u, TableEntry{2, 1, Bound::Lower, Color::Green});
+  EXPECT_FALSE(table.probe(0x1234u, entry));
+  ASSERT_TRUE(table.probe(0x1244u, entry));
+  EXPECT_EQ(entry.depth, 1);
+}
+
+TEST(Unit_TranspositionTable, Attach)
+{
+  TranspositionTable table(4);
+  table.attach(0x42u);
+  table.store(0x1234u, TableEntry{3, 2, Bound::Exact, Color::Blue});
+
+  // The entries are kept for the same board.
+  TableEntry entry;
+  table.attach(0x42u);
+  EXPECT_TRUE(table.probe(0x1234u, entry));
+
+  table.attach(0x43u);
+  EXPECT_EQ(table.fingerprint(), 0x43u);
+  EXPECT_FALSE(table.probe(0x1234u, entry));
+}
+
+} // namespace pge::ai
@@ -0,0 +1,407 @@
+
+#include "Board.hh"
+#include "Random.hh"
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <gtest/gtest.h>
+
+using namespace ::testing;
+
+namespace pge {
+namespace {
+
+void expectSameCells(const Board &lhs, const Board &rhs)
+{
+  ASSERT_EQ(lhs.width(), rhs.width());
+  ASSERT_EQ(lhs.height(), rhs.height());
+
+  for (auto y = 0; y < lhs.height(); ++y)
+  {
+    for (auto x = 0; x < lhs.width(); ++x)
+    {
+      EXPECT_EQ(lhs.at(x, y).owner, rhs.at(x, y).owner);
+      EXPECT_EQ(lhs.at(x, y).color, rhs.at(x, y).color);
+    }
+  }
+}
+
+auto cellsOf(const Board &board, const Owner &owner) -> int
+{
+  auto out = 0;
+  for (auto y = 0; y < board.height(); ++y)
+  {
+    for (auto x = 0; x < board.width(); ++x)
+    {
+      out += (board.at(x, y).owner == owner ? 1 : 0);
+    }
+  }
+
+  return out;
+}
+
+/// @brief - Checks the outcome found by the regions of the board against
+/// the one of regions built from scratch, which have no state kept from
+/// the previous moves.
+void expectSameOutcome(const Board &board)
+{
+  const RegionGraph fresh(
+    board.width(),
+    board.height(),
+    [&board](const int x, const int y) { return board.at(x, y); },
+    board.fullWidth(),
+    board.fullHeight());
+
+  std::array<int, static_cast<int>(Owner::Count)> expected{};
+  std::array<int, static_cast<int>(Owner::Count)> finals{};
+  const auto decided = fresh.decided(expected);
+  ASSERT_EQ(board.regions().decided(finals), decided);
+  if (decided)
+  {
+    EXPECT_EQ(finals, expected);
+  }
+}
+
+} // namespace
+
+TEST(Unit_Board, Seed)
+{
+  const Board board(20, 15, 5u);
+  expectSameCells(board, Board(20, 15, 5u));
+
+  const Board other(20, 15, 6u);
+  auto differences = 0;
+  for (auto y = 0; y < board.height(); ++y)
+  {
+    for (auto x = 0; x < board.width(); ++x)
+    {
+      differences += (board.at(x, y).color != other.at(x, y).color ? 1 : 0);
+    }
+  }
+  EXPECT_GT(differences, 20 * 15 / 2);
+}
+
+TEST(Unit_Board, ParallelGeneration)
+{
+  // Large boards are generated from several threads, each row being its
+  // own stream of colors.
+  constexpr auto WIDTH  = 1030;
+  constexpr auto HEIGHT = 1050;
+  const Board board(WIDTH, HEIGHT, 11u);
+
+  std::vector<std::uint8_t> colors(WIDTH);
+  for (auto y = 2; y < HEIGHT - 2; ++y)
+  {
+    generateColors(11u, static_cast<std::uint64_t>(y), WIDTH, colors.data());
+    for (auto x = 0; x < WIDTH; ++x)
+    {
+      ASSERT_EQ(board.at(x, y).color, static_cast<Color>(colors[x])) << x << "x" << y;
+    }
+  }
+}
+
+TEST(Unit_Board, Decided)
+{
+  for (auto seed = 1u; seed <= 8u; ++seed)
+  {
+    Board board(16, 12, seed);
+
+    // The player picks the best colors while the AI cycles through them,
+    // so that the territories meet in many places and the outcome is often
+    // decided while free regions still touch them.
+    auto owner = Owner::Player;
+    auto color = 0;
+    for (auto id = 0; id < 80 && board.regions().contested() > 0; ++id)
+    {
+      if (owner == Owner::Player)
+      {
+        color = static_cast<int>(board.bestColorFor(owner));
+      }
+      else
+      {
+        do
+        {
+          color = (color + 1) % static_cast<int>(Color::Count);
+        } while (!board.regions().canPick(owner, static_cast<Color>(color)));
+      }
+
+      board.changeColorOf(owner, static_cast<Color>(color));
+      owner = opponentOf(owner);
+      expectSameOutcome(board);
+    }
+
+    while (board.history() > 0)
+    {
+      board.undo();
+      expectSameOutcome(board);
+    }
+  }
+}
+
+TEST(Unit_Board, Complete)
+{
+  for (auto seed = 1u; seed <= 8u; ++seed)
+  {
+    Board board(16, 12, seed);
+
+    auto owner = Owner::Player;
+    while (board.status() == Status::Running)
+    {
+      board.changeColorOf(owner, board.bestColorFor(owner));
+      owner = opponentOf(owner);
+    }
+
+    const auto decided = board.history();
+    board.complete(owner);
+    EXPECT_EQ(0, board.regions().contested());
+
+    // The owners keep alternating from the move which decided the game.
+    auto last = Owner::Nobody;
+    while (board.history() > decided)
+    {
+      const auto undone = board.undo();
+      EXPECT_NE(last, undone);
+      last = undone;
+    }
+    if (last != Owner::Nobody)
+    {
+      EXPECT_EQ(owner, last);
+    }
+  }
+}
+
+TEST(Unit_Board, SaveAndLoad)
+{
+  Board board(70, 12, 7u);
+  board.changeColorOf(Owner::Player, board.bestColorFor(Owner::Player));
+  board.changeColorOf(Owner::AI, board.bestColorFor(Owner::AI));
+
+  const std::string file("board_test.ext");
+  board.save(file);
+
+  // The cells are packed in a byte each, after a small header holding the
+  // dimensions and the seed.
+  std::ifstream in(file, std::ios::binary | std::ios::ate);
+  EXPECT_EQ(static_cast<int>(in.tellg()), 3 * 4 + 8 + 70 * 12);
+
+  Board loaded(2, 2);
+  loaded.load(file);
+  std::remove(file.c_str());
+
+  expectSameCells(board, loaded);
+  EXPECT_EQ(loaded.seed(), 7u);
+  EXPECT_EQ(loaded.occupiedBy(Owner::Player), board.occupiedBy(Owner::Player));
+  EXPECT_EQ(loaded.colorOf(Owner::AI), board.colorOf(Owner::AI));
+}
+
+TEST(Unit_Board, LoadTruncatedFile)
+{
+  const Board board(70, 12);
+
+  const std::string file("board_truncated_test.ext");
+  board.save(file);
+
+  std::string content;
+  {
+    std::ifstream in(file, std::ios::binary);
+    content.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+  }
+
+  // The last row misses a few cells.
+  {
+    std::ofstream out(file, std::ios::binary | std::ios::trunc);
+    out.write(content.data(), static_cast<std::streamsize>(content.size() - 5u));
+  }
+
+  Board loaded(2, 2);
+  EXPECT_ANY_THROW(loaded.load(file));
+  std::remove(file.c_str());
+}
+
+TEST(Unit_Board, LoadLegacyFormat)
+{
+  // Dimensions followed by the owner and the color of each cell, stored
+  // on 4 bytes each.
+  // clang-format off
+  const std::vector<unsigned> legacy = {
+    3u, 2u,
+    2u, 0u, 0u, 1u, 0u, 2u,
+    0u, 3u, 0u, 4u, 1u, 5u,
+  };
+  // clang-format on
+
+  const std::string file("board_legacy_test.ext");
+  {
+    std::ofstream out(file, std::ios::binary);
+    out.write(reinterpret_cast<const char *>(legacy.data()), legacy.size() * sizeof(unsigned));
+  }
+
+  Board board(2, 2, 9u);
+  board.load(file);
+  std::remove(file.c_str());
+
+  // The seed is not part of the file.
+  EXPECT_EQ(board.seed(), 9u);
+  EXPECT_EQ(board.width(), 3);
+  EXPECT_EQ(board.height(), 2);
+  EXPECT_EQ(board.at(0, 0).owner, Owner::Player);
+  EXPECT_EQ(board.at(1, 0).color, Color::Green);
+  EXPECT_EQ(board.at(0, 1).color, Color::Yellow);
+  EXPECT_EQ(board.at(2, 1).owner, Owner::AI);
+  EXPECT_EQ(board.at(2, 1).color, Color::Magenta);
+}
+
+TEST(Unit_Board, WideBoard)
+{
+  // The rows of wide boards span many words.
+  Board board(600, 10);
+  const auto cells = board.width() * board.height();
+
+  auto owner = Owner::Player;
+  for (auto id = 0; id < 6 && board.status() == Status::Running; ++id)
+  {
+    board.changeColorOf(owner, board.bestColorFor(owner));
+    owner = opponentOf(owner);
+  }
+
+  EXPECT_FLOAT_EQ(1.0f * cellsOf(board, Owner::Player) / cells, board.occupiedBy(Owner::Player));
+  EXPECT_FLOAT_EQ(1.0f * cellsOf(board, Owner::AI) / cells, board.occupiedBy(Owner::AI));
+
+  const std::string file("board_wide_test.ext");
+  board.save(file);
+
+  Board loaded(2, 2);
+  loaded.load(file);
+  std::remove(file.c_str());
+  expectSameCells(board, loaded);
+
+  while (board.history() > 0)
+  {
+    board.undo();
+  }
+
+  EXPECT_EQ(cellsOf(board, Owner::Player), 4);
+  EXPECT_EQ(cellsOf(board, Owner::AI), 4);
+}
+
+TEST(Unit_Board, Chunked)
+{
+  constexpr auto DIMS = 4096;
+  Board board(DIMS, DIMS, 17u, Generation::Chunked);
+  EXPECT_EQ(board.fullWidth(), DIMS);
+  EXPECT_LT(board.width(), DIMS);
+  EXPECT_EQ(board.width() % Board::CHUNK_DIMS, 0);
+  EXPECT_EQ(board.at(Board::CHUNK_DIMS - 1, Board::CHUNK_DIMS - 1).owner, Owner::AI);
+
+  // The colors of the cells do not depend on the size of the board.
+  const Board small(100, 80, 17u, Generation::Chunked);
+  for (auto y = 0; y < small.height(); ++y)
+  {
+    for (auto x = 0; x < small.width(); ++x)
+    {
+      EXPECT_EQ(small.at(x, y).color, board.at(x, y).color) << x << "x" << y;
+    }
+  }
+
+  std::vector<Color> colors;
+  auto owner = Owner::Player;
+  while (board.width() < 3 * Board::CHUNK_DIMS && board.status() == Status::Running)
+  {
+    colors.push_back(board.bestColorFor(owner));
+    board.changeColorOf(owner, colors.back());
+    owner = opponentOf(owner);
+  }
+
+  ASSERT_GE(board.width(), 3 * Board::CHUNK_DIMS);
+  EXPECT_EQ(board.history(), static_cast<int>(colors.size()));
+  expectSameOutcome(board);
+
+  // The regions absorbed by the moves never reached the cells which were
+  // not generated: the same moves give the same cells on a board which
+  // ends where the generation stopped.
+  Board bounded(board.width(), board.height(), 17u, Generation::Chunked);
+  owner = Owner::Player;
+  for (const auto &color : colors)
+  {
+    bounded.changeColorOf(owner, color);
+    owner = opponentOf(owner);
+  }
+  expectSameCells(board, bounded);
+
+  const std::string file("board_chunked_test.ext");
+  board.save(file);
+
+  // Only the generated part is saved, after the dimensions of the whole
+  // board.
+  std::ifstream in(file, std::ios::binary | std::ios::ate);
+  EXPECT_EQ(static_cast<int>(in.tellg()), 6 * 4 + 8 + board.width() * board.height());
+
+  Board loaded(2, 2);
+  loaded.load(file);
+  std::remove(file.c_str());
+
+  expectSameCells(board, loaded);
+  EXPECT_EQ(loaded.generation(), Generation::Chunked);
+  EXPECT_EQ(loaded.fullHeight(), DIMS);
+  EXPECT_EQ(loaded.occupiedBy(Owner::AI), board.occupiedBy(Owner::AI));
+
+  while (board.history() > 0)
+  {
+    board.undo();
+  }
+  EXPECT_EQ(cellsOf(board, Owner::Player), 4);
+  EXPECT_EQ(cellsOf(board, Owner::AI), 4);
+}
+
+TEST(Unit_Board, QuadTree)
+{
+  Board board(40, 30, 13u);
+  EXPECT_EQ(board.quadTree(), nullptr);
+
+  board.useQuadTree(true);
+  ASSERT_NE(board.quadTree(), nullptr);
+
+  auto owner = Owner::Player;
+  for (auto id = 0; id < 8 && board.status() == Status::Running; ++id)
+  {
+    board.changeColorOf(owner, board.bestColorFor(owner));
+    owner = opponentOf(owner);
+  }
+  board.undo();
+
+  // The blocks of the tree describe the cells of the board.
+  auto cells = 0;
+  board.quadTree()->visit(
+    [&board, &cells](const int x, const int y, const int size, const QuadTree::Value value) {
+      const auto cell = board.cellOf(value);
+      for (auto cy = y; cy < y + size; ++cy)
+      {
+        for (auto cx = x; cx < x + size; ++cx)
+        {
+          EXPECT_EQ(board.at(cx, cy).owner, cell.owner);
+          EXPECT_EQ(board.at(cx, cy).color, cell.color);
+        }
+      }
+
+      cells += size * size;
+    });
+  EXPECT_EQ(cells, 40 * 30);
+
+  const std::string file("board_quadtree_test.ext");
+  board.save(file);
+
+  // The nodes of the tree are saved instead of the cells.
+  std::ifstream in(file, std::ios::binary | std::ios::ate);
+  EXPECT_LT(static_cast<int>(in.tellg()), 5 * 4 + 8 + board.quadTree()->nodes() + 1);
+
+  Board loaded(2, 2);
+  loaded.load(file);
+  std::remove(file.c_str());
+
+  expectSameCells(board, loaded);
+  EXPECT_EQ(loaded.seed(), 13u);
+  EXPECT_EQ(loaded.colorOf(Owner::Player), board.colorOf(Owner::Player));
+  EXPECT_EQ(loaded.colorOf(Owner::AI), board.colorOf(Owner::AI));
+}
+
+} // namespace pge
@@ -0,0 +1,102 @@
+
+#include "CellKernels.hh"
+#include "PackedCells.hh"
+#include <gtest/gtest.h>
+#include <random>
+
+using namespace ::testing;
+
+namespace pge {
+namespace {
+
+/// @brief - Checks the kernels against a bit by bit version for all the
+/// numbers of bytes they accept.
+void checkKernels()
+{
+  std::mt19937 rng(42);
+
+  for (auto count = 1; count <= kernels::KERNEL_WIDTH; ++count)
+  {
+    std::array<std::uint8_t, kernels::KERNEL_WIDTH> bytes;
+    for (auto &b : bytes)
+    {
+      b = static_cast<std::uint8_t>(rng());
+    }
+
+    std::array<std::uint64_t, kernels::BYTE_BITS> slices;
+    kernels::slice(bytes.data(), count, slices);
+
+    for (auto b = 0; b < kernels::BYTE_BITS; ++b)
+    {
+      auto expected = std::uint64_t{0u};
+      for (auto id = 0; id < count; ++id)
+      {
+        expected |= static_cast<std::uint64_t>((bytes[id] >> b) & 1u) << id;
+      }
+
+      EXPECT_EQ(slices[b], expected) << "count " << count << ", bit " << b;
+    }
+
+    std::array<std::uint8_t, kernels::KERNEL_WIDTH> out;
+    out.fill(0xFF);
+    kernels::unslice(slices.data(), PackedCells::SLICES, count, out.data());
+
+    for (auto id = 0; id < count; ++id)
+    {
+      EXPECT_EQ(out[id], bytes[id] & ((1u << PackedCells::SLICES) - 1u)) << "count " << count;
+    }
+    for (auto id = count; id < kernels::KERNEL_WIDTH; ++id)
+    {
+      EXPECT_EQ(out[id], 0xFF) << "count " << count;
+    }
+  }
+}
+
+} // namespace
+
+TEST(Unit_CellKernels, Dispatched)
+{
+  checkKernels();
+}
+
+TEST(Unit_CellKernels, Scalar)
+{
+  const auto initial = kernels::implementation();
+
+  ASSERT_TRUE(kernels::useImplementation("scalar"));
+  EXPECT_EQ(kernels::implementation(), "scalar");
+  checkKernels();
+
+  EXPECT_FALSE(kernels::useImplementation("unknown"));
+  ASSERT_TRUE(kernels::useImplementation(initial));
+}
+
+TEST(Unit_CellKernels, LoadAndStoreRows)
+{
+  PackedCells cells(130, 2);
+
+  std::vector<std::uint8_t> row(130);
+  for (auto x = 0; x < 130; ++x)
+  {
+    row[x] = PackedCells::pack(Cell{static_cast<Owner>(x % 3), static_cast<Color>(x % 8)});
+  }
+
+  ASSERT_TRUE(cells.loadRow(1, row.data()));
+  EXPECT_EQ(cells.at(129, 1).owner, Owner::Nobody);
+  EXPECT_EQ(cells.at(129, 1).color, Color::Green);
+  EXPECT_EQ(cells.at(65, 1).owner, Owner::Player);
+  EXPECT_EQ(cells.at(65, 1).color, Color::Green);
+  EXPECT_EQ(cells.at(65, 0).owner, Owner::Nobody);
+
+  std::vector<std::uint8_t> out(130);
+  cells.storeRow(1, out.data());
+  EXPECT_EQ(out, row);
+
+  // An owner out of the valid range or extra bits are rejected.
+  row[70] = 3u;
+  EXPECT_FALSE(cells.loadRow(0, row.data()));
+  row[70] = 1u << PackedCells::SLICES;
+  EXPECT_FALSE(cells.loadRow(0, row.data()));
+}
+
+} // namespace pge
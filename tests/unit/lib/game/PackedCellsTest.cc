@@ -0,0 +1,196 @@
+
+#include "PackedCells.hh"
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <random>
+
+using namespace ::testing;
+
+namespace pge {
+
+TEST(Unit_PackedCells, Constructor)
+{
+  PackedCells cells(70, 3);
+
+  EXPECT_EQ(cells.width(), 70);
+  EXPECT_EQ(cells.height(), 3);
+  EXPECT_EQ(cells.at(0, 0).owner, Owner::Nobody);
+  EXPECT_EQ(cells.at(69, 2).owner, Owner::Nobody);
+
+  // Two groups of 64 cells per row, with 5 words each, and a row of
+  // sentinels above and below the grid.
+  EXPECT_EQ(cells.bytes(), 2u * 5u * 5u * sizeof(PackedCells::Word));
+}
+
+TEST(Unit_PackedCells, SetAndGet)
+{
+  PackedCells cells(70, 3);
+
+  cells.set(65, 1, Cell{Owner::Player, Color::White});
+  cells.set(0, 2, Cell{Owner::AI, Color::Cyan});
+  cells.set(64, 1, Cell{Owner::Nobody, Color::Magenta});
+
+  EXPECT_EQ(cells.owner(65, 1), Owner::Player);
+  EXPECT_EQ(cells.color(65, 1), Color::White);
+  EXPECT_EQ(cells.at(0, 2).owner, Owner::AI);
+  EXPECT_EQ(cells.at(0, 2).color, Color::Cyan);
+  EXPECT_EQ(cells.owner(64, 1), Owner::Nobody);
+  EXPECT_EQ(cells.color(64, 1), Color::Magenta);
+  EXPECT_EQ(cells.color(63, 1), Color::Red);
+
+  // Changing the owner keeps the color.
+  cells.setOwner(65, 1, Owner::AI);
+  EXPECT_EQ(cells.owner(65, 1), Owner::AI);
+  EXPECT_EQ(cells.color(65, 1), Color::White);
+}
+
+TEST(Unit_PackedCells, Matches)
+{
+  PackedCells cells(10, 10);
+  cells.set(3, 4, Cell{Owner::Nobody, Color::Blue});
+  cells.set(4, 4, Cell{Owner::Player, Color::Blue});
+
+  EXPECT_TRUE(cells.matches(3, 4, Cell{Owner::Nobody, Color::Blue}));
+  EXPECT_FALSE(cells.matches(3, 4, Cell{Owner::Nobody, Color::Green}));
+  EXPECT_FALSE(cells.matches(4, 4, Cell{Owner::Nobody, Color::Blue}));
+  EXPECT_TRUE(cells.matches(4, 4, Cell{Owner::Player, Color::Blue}));
+}
+
+TEST(Unit_PackedCells, Border)
+{
+  PackedCells cells(64, 2);
+  cells.set(63, 1, Cell{Owner::Nobody, Color::Red});
+
+  // The border never matches a cell, whatever its owner.
+  for (auto o = 0; o < static_cast<int>(Owner::Count); ++o)
+  {
+    const Cell cell{static_cast<Owner>(o), Color::Red};
+    EXPECT_FALSE(cells.matches(-1, 0, cell));
+    EXPECT_FALSE(cells.matches(64, 1, cell));
+    EXPECT_FALSE(cells.matches(10, -1, cell));
+    EXPECT_FALSE(cells.matches(10, 2, cell));
+  }
+
+  const auto id        = cells.index(63, 1);
+  const auto neighbors = cells.neighborsOf(id);
+  EXPECT_EQ(neighbors[0], cells.index(64, 1));
+  EXPECT_EQ(neighbors[1], cells.index(62, 1));
+  EXPECT_EQ(neighbors[2], cells.index(63, 2));
+  EXPECT_EQ(neighbors[3], cells.index(63, 0));
+
+  EXPECT_TRUE(cells.matches(id, Cell{Owner::Nobody, Color::Red}));
+  cells.setOwner(id, Owner::Player);
+  EXPECT_EQ(cells.owner(63, 1), Owner::Player);
+  EXPECT_EQ(cells.owner(62, 1), Owner::Nobody);
+}
+
+TEST(Unit_PackedCells, Rows)
+{
+  constexpr auto WIDTH  = 75;
+  constexpr auto HEIGHT = 13;
+
+  PackedCells cells(WIDTH, HEIGHT);
+
+  std::mt19937 rng(42);
+  for (auto y = 0; y < HEIGHT; ++y)
+  {
+    for (auto x = 0; x < WIDTH; ++x)
+    {
+      cells.set(x, y, Cell{static_cast<Owner>(rng() % 3), static_cast<Color>(rng() % 8)});
+    }
+  }
+
+  std::vector<std::uint8_t> row(WIDTH);
+  for (auto y = 0; y < HEIGHT; ++y)
+  {
+    cells.storeRow(y, row.data());
+    for (auto x = 0; x < WIDTH; ++x)
+    {
+      EXPECT_EQ(PackedCells::unpack(row[x]).owner, cells.owner(x, y));
+      EXPECT_EQ(PackedCells::unpack(row[x]).color, cells.color(x, y));
+      EXPECT_EQ(cells.position(cells.index(x, y)), std::make_pair(x, y));
+
+      const auto neighbors = cells.neighborsOf(cells.index(x, y));
+      EXPECT_EQ(neighbors[0], cells.index(x + 1, y));
+      EXPECT_EQ(neighbors[1], cells.index(x - 1, y));
+      EXPECT_EQ(neighbors[2], cells.index(x, y + 1));
+      EXPECT_EQ(neighbors[3], cells.index(x, y - 1));
+    }
+  }
+
+  // Rows can be loaded back, keeping the border of the grid.
+  PackedCells loaded(WIDTH, HEIGHT);
+  for (auto y = 0; y < HEIGHT; ++y)
+  {
+    cells.storeRow(y, row.data());
+    ASSERT_TRUE(loaded.loadRow(y, row.data()));
+  }
+  for (auto y = -1; y <= HEIGHT; ++y)
+  {
+    for (auto x = -1; x <= WIDTH; ++x)
+    {
+      const auto inside = (x >= 0 && y >= 0 && x < WIDTH && y < HEIGHT);
+      const auto cell   = (inside ? cells.at(x, y) : Cell{Owner::Nobody, Color::Red});
+      EXPECT_EQ(loaded.matches(x, y, cell), inside);
+    }
+  }
+}
+
+TEST(Unit_PackedCells, Fill)
+{
+  constexpr auto WIDTH  = 150;
+  constexpr auto HEIGHT = 20;
+
+  // Two colors only, so that the regions are large and cross the words.
+  PackedCells cells(WIDTH, HEIGHT);
+  std::mt19937 rng(7);
+  for (auto y = 0; y < HEIGHT; ++y)
+  {
+    for (auto x = 0; x < WIDTH; ++x)
+    {
+      cells.set(x, y, Cell{Owner::Nobody, static_cast<Color>(rng() % 3 == 0 ? 1 : 0)});
+    }
+  }
+
+  const Cell free{Owner::Nobody, Color::Red};
+  ASSERT_TRUE(cells.matches(3, 4, free));
+
+  // Reference flood fill, visiting one cell at a time.
+  std::vector<bool> expected(WIDTH * HEIGHT, false);
+  std::vector<std::pair<int, int>> stack{{3, 4}};
+  while (!stack.empty())
+  {
+    const auto [x, y] = stack.back();
+    stack.pop_back();
+    if (x < 0 || y < 0 || x >= WIDTH || y >= HEIGHT || expected[y * WIDTH + x]
+        || !cells.matches(x, y, free))
+    {
+      continue;
+    }
+
+    expected[y * WIDTH + x] = true;
+    stack.insert(stack.end(), {{x + 1, y}, {x - 1, y}, {x, y + 1}, {x, y - 1}});
+  }
+
+  std::vector<int> filled;
+  std::vector<PackedCells::Seed> pending;
+  const auto count = cells.fill(cells.index(3, 4), free, Owner::AI, filled, pending);
+  EXPECT_EQ(count, static_cast<int>(std::count(expected.begin(), expected.end(), true)));
+  ASSERT_EQ(filled.size(), static_cast<std::size_t>(count));
+
+  for (const auto &id : filled)
+  {
+    const auto [x, y] = cells.position(id);
+    EXPECT_TRUE(expected[y * WIDTH + x]) << x << "x" << y;
+  }
+  for (auto y = 0; y < HEIGHT; ++y)
+  {
+    for (auto x = 0; x < WIDTH; ++x)
+    {
+      const auto owner = expected[y * WIDTH + x] ? Owner::AI : Owner::Nobody;
+      EXPECT_EQ(cells.owner(x, y), owner) << x << "x" << y;
+    }
+  }
+}
+
+} // namespace pge
@@ -0,0 +1,112 @@
+
+#include "QuadTree.hh"
+#include <gtest/gtest.h>
+#include <random>
+#include <sstream>
+
+using namespace ::testing;
+
+namespace pge {
+
+TEST(Unit_QuadTree, UniformGrid)
+{
+  QuadTree tree(100, 60, [](const int, const int) { return QuadTree::Value{3u}; });
+
+  EXPECT_EQ(tree.width(), 100);
+  EXPECT_EQ(tree.height(), 60);
+  EXPECT_EQ(tree.at(99, 59), 3u);
+
+  auto cells = 0;
+  tree.visit([&cells](const int x, const int y, const int size, const QuadTree::Value value) {
+    EXPECT_EQ(value, 3u);
+    EXPECT_LE(x + size, 100);
+    EXPECT_LE(y + size, 60);
+    cells += size * size;
+  });
+  EXPECT_EQ(cells, 100 * 60);
+
+  // The blocks follow the edges of the grid, not its area.
+  EXPECT_LT(tree.nodes(), 100 * 60 / 20);
+}
+
+TEST(Unit_QuadTree, SetAndMerge)
+{
+  QuadTree tree(64, 64, [](const int, const int) { return QuadTree::Value{0u}; });
+  EXPECT_EQ(tree.nodes(), 1);
+
+  tree.set(10, 20, 1u);
+  EXPECT_EQ(tree.at(10, 20), 1u);
+  EXPECT_EQ(tree.at(11, 20), 0u);
+  EXPECT_EQ(tree.nodes(), 1 + 4 * 6);
+
+  // Filling the block around the cell merges it back.
+  for (auto y = 16; y < 24; ++y)
+  {
+    for (auto x = 8; x < 16; ++x)
+    {
+      tree.set(x, y, 1u);
+    }
+  }
+  EXPECT_EQ(tree.nodes(), 1 + 4 * 3);
+
+  tree.set(10, 20, 0u);
+  tree.set(10, 20, 1u);
+  EXPECT_EQ(tree.nodes(), 1 + 4 * 3);
+
+  for (auto y = 16; y < 24; ++y)
+  {
+    for (auto x = 8; x < 16; ++x)
+    {
+      tree.set(x, y, 0u);
+    }
+  }
+  EXPECT_EQ(tree.nodes(), 1);
+
+  // The nodes released by the merges are dropped.
+  EXPECT_GT(tree.bytes(), 100u);
+  tree.compact();
+  EXPECT_EQ(tree.nodes(), 1);
+  EXPECT_LT(tree.bytes(), 100u);
+  EXPECT_EQ(tree.at(10, 20), 0u);
+}
+
+TEST(Unit_QuadTree, SaveAndLoad)
+{
+  constexpr auto WIDTH  = 37;
+  constexpr auto HEIGHT = 21;
+
+  std::mt19937 rng(42);
+  std::vector<QuadTree::Value> values(WIDTH * HEIGHT);
+  for (auto &v : values)
+  {
+    v = static_cast<QuadTree::Value>(rng() % 4 == 0 ? rng() % 3 : 0u);
+  }
+
+  const auto accessor = [&values](const int x, const int y) { return values[y * WIDTH + x]; };
+  QuadTree tree(WIDTH, HEIGHT, accessor);
+
+  std::stringstream stream;
+  tree.save(stream);
+
+  QuadTree loaded;
+  ASSERT_TRUE(loaded.load(stream, WIDTH, HEIGHT));
+  EXPECT_EQ(loaded.nodes(), tree.nodes());
+  for (auto y = 0; y < HEIGHT; ++y)
+  {
+    for (auto x = 0; x < WIDTH; ++x)
+    {
+      EXPECT_EQ(loaded.at(x, y), accessor(x, y));
+    }
+  }
+
+  // A truncated tree or one which does not fit the grid is rejected.
+  const auto raw = stream.str();
+  std::stringstream truncated(raw.substr(0, raw.size() / 2));
+  EXPECT_FALSE(loaded.load(truncated, WIDTH, HEIGHT));
+  EXPECT_EQ(loaded.nodes(), 0);
+
+  std::stringstream uniform(std::string(1u, '\0'));
+  EXPECT_FALSE(loaded.load(uniform, WIDTH, HEIGHT));
+}
+
+} // namespace pge
@@ -0,0 +1,51 @@
+
+#include "Cell.hh"
+#include "Random.hh"
+#include <algorithm>
+#include <array>
+#include <gtest/gtest.h>
+#include <vector>
+
+using namespace ::testing;
+
+namespace pge {
+
+TEST(Unit_Random, Reproducible)
+{
+  std::vector<std::uint8_t> colors(1000), again(1000), prefix(50);
+
+  generateColors(7u, 3u, 1000, colors.data());
+  generateColors(7u, 3u, 1000, again.data());
+  EXPECT_EQ(colors, again);
+
+  // A color does not depend on the number of colors generated.
+  generateColors(7u, 3u, 50, prefix.data());
+  EXPECT_TRUE(std::equal(prefix.begin(), prefix.end(), colors.begin()));
+
+  // Another seed or another stream gives other colors.
+  generateColors(8u, 3u, 1000, again.data());
+  EXPECT_NE(colors, again);
+  generateColors(7u, 4u, 1000, again.data());
+  EXPECT_NE(colors, again);
+}
+
+TEST(Unit_Random, Distribution)
+{
+  constexpr auto COUNT = 80000;
+  std::vector<std::uint8_t> colors(COUNT);
+  generateColors(1u, 0u, COUNT, colors.data());
+
+  std::array<int, static_cast<int>(Color::Count)> counts{};
+  for (const auto color : colors)
+  {
+    ASSERT_LT(color, static_cast<int>(Color::Count));
+    ++counts[color];
+  }
+
+  for (const auto count : counts)
+  {
+    EXPECT_NEAR(count, COUNT / counts.size(), COUNT / 100);
+  }
+}
+
+} // namespace pge
@@ -0,0 +1,293 @@
+
+#include "RegionGraph.hh"
+#include <gtest/gtest.h>
+
+using namespace ::testing;
+
+namespace pge {
+namespace {
+
+constexpr auto P = Cell{Owner::Player, Color::Red};
+constexpr auto A = Cell{Owner::AI, Color::Blue};
+constexpr auto R = Cell{Owner::Nobody, Color::Red};
+constexpr auto G = Cell{Owner::Nobody, Color::Green};
+constexpr auto B = Cell{Owner::Nobody, Color::Blue};
+
+constexpr auto WIDTH  = 4;
+constexpr auto HEIGHT = 3;
+
+// clang-format off
+const std::vector<Cell> CELLS = {
+  P, G, G, B,
+  R, G, B, B,
+  R, R, G, A,
+};
+// clang-format on
+
+auto generateGraph() -> RegionGraph
+{
+  return RegionGraph(WIDTH, HEIGHT, [](const int x, const int y) {
+    return CELLS[y * WIDTH + x];
+  });
+}
+
+} // namespace
+
+TEST(Unit_RegionGraph, Constructor)
+{
+  auto graph = generateGraph();
+
+  // Player, top green, blue, red, bottom green and AI.
+  EXPECT_EQ(graph.size(), 6);
+  EXPECT_FALSE(graph.inContact());
+
+  EXPECT_EQ(graph.owner(0), Owner::Player);
+  EXPECT_EQ(graph.region(0).size, 1);
+  EXPECT_EQ(graph.region(1).color, Color::Green);
+  EXPECT_EQ(graph.region(1).size, 3);
+
+  EXPECT_EQ(graph.color(Owner::Player), Color::Red);
+  EXPECT_EQ(graph.color(Owner::AI), Color::Blue);
+
+  EXPECT_EQ(graph.count(Owner::Player), 1);
+  EXPECT_EQ(graph.count(Owner::AI), 1);
+  EXPECT_EQ(graph.count(Owner::Nobody), 10);
+  EXPECT_EQ(graph.contested(), 10);
+}
+
+TEST(Unit_RegionGraph, Gains)
+{
+  auto graph = generateGraph();
+
+  EXPECT_EQ(graph.gain(Owner::Player, Color::Green), 3);
+  EXPECT_EQ(graph.gain(Owner::Player, Color::Red), 3);
+  EXPECT_EQ(graph.gain(Owner::Player, Color::Blue), 0);
+
+  EXPECT_EQ(graph.gain(Owner::AI, Color::Blue), 3);
+  EXPECT_EQ(graph.gain(Owner::AI, Color::Green), 1);
+}
+
+TEST(Unit_RegionGraph, BestColor)
+{
+  auto graph = generateGraph();
+
+  // Red brings as many cells as green, but it is the color of the player.
+  EXPECT_EQ(graph.bestColor(Owner::Player), Color::Green);
+  EXPECT_EQ(graph.bestColor(Owner::AI), Color::Green);
+
+  // Once the player has nothing left to gain, the color is drawn among the
+  // ones it can pick, the same way for all the copies of the graph.
+  // clang-format off
+  const std::vector<Cell> cells = {
+    R, P, A, G, G,
+  };
+  // clang-format on
+  RegionGraph wall(5, 1, [&cells](const int x, const int) { return cells[x]; });
+
+  std::vector<int> absorbed;
+  wall.absorb(Owner::Player, Color::Red, absorbed);
+
+  const auto color = wall.bestColor(Owner::Player);
+  EXPECT_TRUE(wall.canPick(Owner::Player, color));
+  EXPECT_EQ(wall.gain(Owner::Player, color), 0);
+  EXPECT_EQ(RegionGraph(wall).bestColor(Owner::Player), color);
+}
+
+TEST(Unit_RegionGraph, Absorb)
+{
+  auto graph = generateGraph();
+
+  std::vector<int> absorbed;
+  graph.absorb(Owner::Player, Color::Green, absorbed);
+  ASSERT_EQ(absorbed.size(), 1u);
+  EXPECT_EQ(graph.owner(absorbed[0]), Owner::Player);
+  EXPECT_EQ(graph.color(Owner::Player), Color::Green);
+  EXPECT_EQ(graph.gain(Owner::Player, Color::Green), 0);
+  EXPECT_EQ(graph.gain(Owner::Player, Color::Blue), 3);
+  EXPECT_EQ(graph.count(Owner::Player), 4);
+  EXPECT_EQ(graph.contested(), 7);
+
+  absorbed.clear();
+  graph.absorb(Owner::AI, Color::Blue, absorbed);
+  ASSERT_EQ(absorbed.size(), 1u);
+  EXPECT_TRUE(graph.inContact());
+  EXPECT_EQ(graph.gain(Owner::Player, Color::Blue), 0);
+  EXPECT_EQ(graph.gain(Owner::AI, Color::Green), 1);
+  EXPECT_EQ(graph.count(Owner::AI), 4);
+  EXPECT_EQ(graph.count(Owner::Nobody), 4);
+  EXPECT_EQ(graph.contested(), 4);
+}
+
+TEST(Unit_RegionGraph, Hash)
+{
+  auto lhs = generateGraph();
+  auto rhs = generateGraph();
+  EXPECT_EQ(lhs.hash(), rhs.hash());
+
+  std::vector<int> absorbed;
+  lhs.absorb(Owner::Player, Color::Green, absorbed);
+  EXPECT_NE(lhs.hash(), rhs.hash());
+
+  // The same position reached with the moves played in another order.
+  lhs.absorb(Owner::AI, Color::Blue, absorbed);
+  rhs.absorb(Owner::AI, Color::Blue, absorbed);
+  rhs.absorb(Owner::Player, Color::Green, absorbed);
+  EXPECT_EQ(lhs.hash(), rhs.hash());
+
+  // Picking a color which brings no cell still changes the position.
+  const auto before = lhs.hash();
+  lhs.absorb(Owner::AI, Color::Yellow, absorbed);
+  EXPECT_NE(lhs.hash(), before);
+}
+
+TEST(Unit_RegionGraph, HashDependsOnBoard)
+{
+  // clang-format off
+  const std::vector<Cell> lhsCells = {
+    P, G, G,
+    R, R, A,
+  };
+  const std::vector<Cell> rhsCells = {
+    P, G, G,
+    R, G, A,
+  };
+  // clang-format on
+
+  const RegionGraph lhs(3, 2, [&lhsCells](const int x, const int y) {
+    return lhsCells[y * 3 + x];
+  });
+  const RegionGraph rhs(3, 2, [&rhsCells](const int x, const int y) {
+    return rhsCells[y * 3 + x];
+  });
+
+  // Both boards have the same regions numbering, but their positions
+  // should not be confused.
+  ASSERT_EQ(lhs.size(), rhs.size());
+  EXPECT_NE(lhs.fingerprint(), rhs.fingerprint());
+  EXPECT_NE(lhs.hash(), rhs.hash());
+
+  const auto copy = lhs;
+  EXPECT_EQ(copy.fingerprint(), lhs.fingerprint());
+  EXPECT_EQ(generateGraph().fingerprint(), generateGraph().fingerprint());
+}
+
+TEST(Unit_RegionGraph, Outside)
+{
+  // The graph describes the first 4 cells of a board of 6 cells: the last
+  // 2 ones are gathered in the outside, next to the green cell.
+  // clang-format off
+  const std::vector<Cell> cells = {
+    R, P, A, G,
+  };
+  // clang-format on
+  RegionGraph graph(4, 1, [&cells](const int x, const int) { return cells[x]; }, 6, 1);
+
+  ASSERT_EQ(graph.outside(), graph.size() - 1);
+  EXPECT_EQ(graph.region(graph.outside()).size, 2);
+  EXPECT_EQ(graph.count(Owner::Nobody), 4);
+  EXPECT_EQ(graph.contested(), 2);
+  EXPECT_TRUE(graph.exposed());
+  EXPECT_EQ(generateGraph().outside(), -1);
+  EXPECT_FALSE(generateGraph().exposed());
+
+  // The AI gets the outside along with the green cell.
+  std::array<int, static_cast<int>(Owner::Count)> finals{};
+  EXPECT_TRUE(graph.decided(finals));
+  EXPECT_EQ(finals[static_cast<int>(Owner::Player)], 2);
+  EXPECT_EQ(finals[static_cast<int>(Owner::AI)], 4);
+
+  // The outside can't be absorbed, but still belongs to the AI once no
+  // free cell is left to gain.
+  std::vector<int> absorbed;
+  graph.absorb(Owner::Player, Color::Red, absorbed);
+  graph.absorb(Owner::AI, Color::Green, absorbed);
+  EXPECT_EQ(graph.contested(), 0);
+  EXPECT_EQ(graph.gain(Owner::AI, Color::Red), 0);
+  EXPECT_EQ(graph.owner(graph.outside()), Owner::Nobody);
+  EXPECT_TRUE(graph.decided(finals));
+  EXPECT_EQ(finals[static_cast<int>(Owner::Player)], 2);
+  EXPECT_EQ(finals[static_cast<int>(Owner::AI)], 4);
+
+  std::vector<int> released;
+  graph.undo(released);
+  EXPECT_TRUE(graph.exposed());
+  EXPECT_EQ(graph.contested(), 1);
+}
+
+TEST(Unit_RegionGraph, Undo)
+{
+  auto graph = generateGraph();
+  const auto hash = graph.hash();
+
+  std::vector<int> absorbed;
+  graph.absorb(Owner::Player, Color::Green, absorbed);
+  graph.absorb(Owner::AI, Color::Blue, absorbed);
+  EXPECT_EQ(graph.history(), 2);
+
+  std::vector<int> released;
+  EXPECT_EQ(graph.undo(released), Owner::AI);
+  ASSERT_EQ(released.size(), 1u);
+  EXPECT_EQ(graph.owner(released[0]), Owner::Nobody);
+  EXPECT_FALSE(graph.inContact());
+  EXPECT_EQ(graph.color(Owner::AI), Color::Blue);
+  EXPECT_EQ(graph.gain(Owner::Player, Color::Blue), 3);
+  EXPECT_EQ(graph.gain(Owner::AI, Color::Blue), 3);
+  EXPECT_EQ(graph.count(Owner::AI), 1);
+  EXPECT_EQ(graph.contested(), 7);
+
+  EXPECT_EQ(graph.undo(released), Owner::Player);
+  EXPECT_EQ(graph.history(), 0);
+  EXPECT_EQ(graph.hash(), hash);
+  EXPECT_EQ(graph.color(Owner::Player), Color::Red);
+  EXPECT_EQ(graph.gain(Owner::Player, Color::Green), 3);
+  EXPECT_EQ(graph.gain(Owner::Player, Color::Blue), 0);
+  EXPECT_EQ(graph.count(Owner::Player), 1);
+  EXPECT_EQ(graph.count(Owner::Nobody), 10);
+  EXPECT_EQ(graph.contested(), 10);
+
+  EXPECT_EQ(graph.undo(released), Owner::Nobody);
+
+  // The graph can be played again after being restored.
+  graph.absorb(Owner::Player, Color::Green, absorbed);
+  EXPECT_EQ(graph.gain(Owner::Player, Color::Blue), 3);
+  EXPECT_EQ(graph.count(Owner::Player), 4);
+}
+
+TEST(Unit_RegionGraph, Decided)
+{
+  auto graph = generateGraph();
+  std::array<int, static_cast<int>(Owner::Count)> finals{};
+  EXPECT_FALSE(graph.decided(finals));
+
+  // The red region and the bottom green one can still be reached by both
+  // owners.
+  std::vector<int> absorbed;
+  graph.absorb(Owner::Player, Color::Green, absorbed);
+  graph.absorb(Owner::AI, Color::Blue, absorbed);
+  graph.absorb(Owner::Player, Color::Red, absorbed);
+  EXPECT_FALSE(graph.decided(finals));
+
+  graph.absorb(Owner::AI, Color::Green, absorbed);
+  EXPECT_TRUE(graph.decided(finals));
+  EXPECT_EQ(finals[static_cast<int>(Owner::Player)], 7);
+  EXPECT_EQ(finals[static_cast<int>(Owner::AI)], 5);
+}
+
+TEST(Unit_RegionGraph, DecidedBeforeContact)
+{
+  // The territories are separated by an owned wall: each owner
+  // gets the free cells on its side.
+  // clang-format off
+  const std::vector<Cell> cells = {
+    R, P, A, G, G,
+  };
+  // clang-format on
+  RegionGraph graph(5, 1, [&cells](const int x, const int) { return cells[x]; });
+
+  std::array<int, static_cast<int>(Owner::Count)> finals{};
+  EXPECT_TRUE(graph.decided(finals));
+  EXPECT_EQ(finals[static_cast<int>(Owner::Player)], 2);
+  EXPECT_EQ(finals[static_cast<int>(Owner::AI)], 3);
+}
+
+} // namespace pge